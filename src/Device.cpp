@@ -0,0 +1,159 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifdef _WIN32
+#include "include/win.h"
+#endif
+#include <iostream>
+#include <fstream>
+#include <format>
+
+#include "Device.h"
+#include "classes/Tracer.h"
+#include "extern/libOpenWinControls/src/include/ControllerFeature.h"
+#include "extern/libOpenWinControls/src/controller/ControllerV1.h"
+#include "extern/libOpenWinControls/src/controller/ControllerV2.h"
+
+namespace OWCL {
+    static constexpr char win3[] = "G1618-03";
+    static constexpr char win4[] = "G1618-04";
+    static constexpr char mini24[] = "G1617-01";
+    static constexpr char mini25[] = "G1617-02";
+    static constexpr char mini25L[] = "G1617-02-L";
+    static constexpr char max2_22[] = "G1619-04";
+    static constexpr char max2_25[] = "G1619-05";
+    static constexpr char win5[] = "G1618-05";
+
+    std::string getProduct() {
+        const OWC::TraceSpan span ("getProduct");
+
+#ifdef __linux__
+        std::ifstream prodDmi;
+        std::string prod;
+
+        prodDmi.open("/sys/class/dmi/id/board_name");
+        if (!prodDmi.is_open())
+            return "";
+
+        std::getline(prodDmi, prod);
+        prodDmi.close();
+
+        return prod;
+#elif defined(_WIN32)
+        DWORD bufSz = 0;
+        std::unique_ptr<TCHAR[]> buf;
+        LSTATUS ret;
+        HKEY rkey;
+
+        ret = RegOpenKeyExA(HKEY_LOCAL_MACHINE, R"(HARDWARE\DESCRIPTION\System\BIOS)", 0, KEY_READ, &rkey);
+        if (ret != ERROR_SUCCESS) {
+            std::cerr << "failed to open bios subkey, code: " << ret;
+            return "";
+        }
+
+        ret = RegGetValueA(rkey, nullptr, "BaseBoardProduct", RRF_RT_REG_SZ, nullptr, nullptr, &bufSz);
+        if (ret != ERROR_SUCCESS) {
+            std::cerr << "failed to read size for reg value, code " << ret;
+            RegCloseKey(rkey);
+            return "";
+        }
+
+        bufSz += sizeof(TCHAR);
+        buf = std::make_unique<TCHAR[]>(bufSz);
+
+        ret = RegGetValueA(rkey, nullptr, "BaseBoardProduct", RRF_RT_REG_SZ, nullptr, buf.get(), &bufSz);
+        if (ret != ERROR_SUCCESS) {
+            std::cerr << "failed to read reg value, code " << ret;
+            RegCloseKey(rkey);
+            return "";
+        }
+
+        RegCloseKey(rkey);
+        return std::string(buf.get());
+#else
+        return "";
+#endif
+    }
+
+    std::shared_ptr<OWC::Controller> getDevice(const std::string &product, OWC::Diagnostics &diag) {
+        std::shared_ptr<OWC::Controller> device;
+
+        if (product == win4)
+            device = std::make_shared<OWC::ControllerV1>(OWC::ControllerFeature::DeadZoneControlV1 | OWC::ControllerFeature::ShoulderLedsV1 | OWC::ControllerFeature::RumbleV1);
+        else if (product == mini24 || product == max2_22 || product == max2_25)
+            device = std::make_shared<OWC::ControllerV1>(OWC::ControllerFeature::DeadZoneControlV1 | OWC::ControllerFeature::RumbleV1);
+        //else if (product == win3)
+        //    device = std::make_shared<OWC::ControllerV1>();
+        else if (product == win5)
+            device = std::make_shared<OWC::ControllerV2>(OWC::ControllerFeature::RumbleV1 | OWC::ControllerFeature::XinputMappingV1 | OWC::ControllerFeature::BackButton4);
+        else if (product == mini25 || product == mini25L)
+            device = std::make_shared<OWC::ControllerV2>(OWC::ControllerFeature::DeadZoneControlV1 | OWC::ControllerFeature::RumbleV1 | OWC::ControllerFeature::XinputMappingV1);
+        else
+            diag.error("unknown device: " + product);
+
+        return device;
+    }
+
+    bool isCompatible(const std::string &product, const OWC::DeviceState &state, OWC::Diagnostics &diag) {
+        std::pair<int, int> version = {0, 0};
+        bool compCheck = false;
+
+        /*if (product == win3) {
+            return true;
+
+        } else*/ if (product == win4) {
+            version = state.kVersion;
+            compCheck = version.first >= 0x4 && version.second >= 0x7;
+
+        } else if (product == mini24) {
+            version = state.kVersion;
+            compCheck = version.first >= 0x5 && version.second >= 0x3;
+
+        } else if (product == max2_22 || product == max2_25) {
+            version = state.kVersion;
+            compCheck = version.first >= 1 && version.second >= 0x23;
+
+        } else if (product == win5) {
+            version = state.version;
+            compCheck = version.first >= 1 && version.second >= 0x8;
+
+        } else if (product == mini25 || product == mini25L) {
+            version = state.version;
+            compCheck = version.first >= 1 && version.second >= 0x22;
+        }
+
+        if (!compCheck)
+            diag.error(std::format("version {}.{} is not supported, please update.", version.first, version.second));
+
+        return compCheck;
+    }
+
+    std::string getVersionString(const std::shared_ptr<OWC::Controller> &gpd) {
+        const OWC::DeviceState &state = OWC::DeviceSession::getInstance()->getState();
+
+        if (gpd->getControllerType() == 1) {
+            const auto [xmaj, xmin] = state.xVersion;
+            const auto [kmaj, kmin] = state.kVersion;
+
+            return std::format("{:x}.{:x}/{:x}.{:x}", xmaj, xmin, kmaj, kmin);
+        }
+
+        const auto [major, minor] = state.version;
+
+        return std::format("{:x}.{:x}", major, minor);
+    }
+}
@@ -0,0 +1,34 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "extern/libOpenWinControls/src/controller/Controller.h"
+#include "classes/DeviceSession.h"
+#include "classes/Diagnostics.h"
+
+namespace OWCL {
+    // board name, from DMI on linux and the BIOS registry key on windows
+    [[nodiscard]] std::string getProduct();
+    // controller for a known board, nullptr otherwise
+    [[nodiscard]] std::shared_ptr<OWC::Controller> getDevice(const std::string &product, OWC::Diagnostics &diag = OWC::Diagnostics::console());
+    [[nodiscard]] bool isCompatible(const std::string &product, const OWC::DeviceState &state, OWC::Diagnostics &diag = OWC::Diagnostics::console());
+    [[nodiscard]] std::string getVersionString(const std::shared_ptr<OWC::Controller> &gpd);
+}
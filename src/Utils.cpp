@@ -17,9 +17,29 @@
  */
 #include <iostream>
 #include <fstream>
+#include <filesystem>
+#include <algorithm>
 #include <format>
+#include <chrono>
+#include <unordered_map>
 
 #include "Utils.h"
+#include "classes/BatchScript.h"
+#include "classes/FileLogger.h"
+#include "classes/ConfigCache.h"
+#include "classes/FileWatcher.h"
+#include "classes/Tracer.h"
+#include "classes/DeviceSession.h"
+#include "classes/ProcessMonitor.h"
+#include "classes/SwitchRules.h"
+#include "classes/KeyTable.h"
+#include "classes/MacroCompiler.h"
+#include "classes/MacroTimeline.h"
+#include "classes/ProfileReader.h"
+#include "classes/ProfileWriter.h"
+#include "classes/ProfileValidator.h"
+#include "classes/WorkPool.h"
+#include "include/Options.h"
 #include "extern/libOpenWinControls/src/Utils.h"
 #include "extern/libOpenWinControls/src/include/ControllerFeature.h"
 #include "extern/libOpenWinControls/src/controller/ControllerV1.h"
@@ -27,648 +47,1002 @@
 #include "extern/yaml-cpp/include/yaml-cpp/yaml.h"
 
 namespace OWCL {
-    static constexpr std::array<std::pair<std::string_view, OWC::Button>, 21> kbmKeys = {{
-        {"A", OWC::Button::KBD_A},
-        {"B", OWC::Button::KBD_B},
-        {"X", OWC::Button::KBD_X},
-        {"Y", OWC::Button::KBD_Y},
-        {"DPAD_UP", OWC::Button::KBD_DPAD_UP},
-        {"DPAD_DOWN", OWC::Button::KBD_DPAD_DOWN},
-        {"DPAD_LEFT", OWC::Button::KBD_DPAD_LEFT},
-        {"DPAD_RIGHT", OWC::Button::KBD_DPAD_RIGHT},
-        {"L_ANALOG_UP", OWC::Button::KBD_LANALOG_UP},
-        {"L_ANALOG_DOWN", OWC::Button::KBD_LANALOG_DOWN},
-        {"L_ANALOG_LEFT", OWC::Button::KBD_LANALOG_LEFT},
-        {"L_ANALOG_RIGHT", OWC::Button::KBD_LANALOG_RIGHT},
-        {"L1", OWC::Button::KBD_L1},
-        {"L2", OWC::Button::KBD_L2},
-        {"L3", OWC::Button::KBD_L3},
-        {"R1", OWC::Button::KBD_R1},
-        {"R2", OWC::Button::KBD_R2},
-        {"R3", OWC::Button::KBD_R3},
-        {"START", OWC::Button::KBD_START},
-        {"SELECT", OWC::Button::KBD_SELECT},
-        {"MENU", OWC::Button::KBD_MENU}
+    static constexpr std::array<std::pair<std::string_view, OWC::Button>, 21> kbmLabels = {{
+        {"DPAD Up:\t\t", OWC::Button::KBD_DPAD_UP},
+        {"DPAD Down:\t\t", OWC::Button::KBD_DPAD_DOWN},
+        {"DPAD Left:\t\t", OWC::Button::KBD_DPAD_LEFT},
+        {"DPAD Right:\t\t", OWC::Button::KBD_DPAD_RIGHT},
+        {"A:\t\t\t", OWC::Button::KBD_A},
+        {"B:\t\t\t", OWC::Button::KBD_B},
+        {"X:\t\t\t", OWC::Button::KBD_X},
+        {"Y:\t\t\t", OWC::Button::KBD_Y},
+        {"Start:\t\t\t", OWC::Button::KBD_START},
+        {"Select:\t\t\t", OWC::Button::KBD_SELECT},
+        {"Menu:\t\t\t", OWC::Button::KBD_MENU},
+        {"Left Analog Up:\t\t", OWC::Button::KBD_LANALOG_UP},
+        {"Left Analog Down:\t", OWC::Button::KBD_LANALOG_DOWN},
+        {"Left Analog Left:\t", OWC::Button::KBD_LANALOG_LEFT},
+        {"Left Analog Right:\t", OWC::Button::KBD_LANALOG_RIGHT},
+        {"L1:\t\t\t", OWC::Button::KBD_L1},
+        {"L2:\t\t\t", OWC::Button::KBD_L2},
+        {"L3:\t\t\t", OWC::Button::KBD_L3},
+        {"R1:\t\t\t", OWC::Button::KBD_R1},
+        {"R2:\t\t\t", OWC::Button::KBD_R2},
+        {"R3:\t\t\t", OWC::Button::KBD_R3}
     }};
 
-    static constexpr std::array<std::pair<std::string_view, OWC::Button>, 25> xinptKeys = {{
-        {"X_A", OWC::Button::X_A},
-        {"X_B", OWC::Button::X_B},
-        {"X_X", OWC::Button::X_X},
-        {"X_Y", OWC::Button::X_Y},
-        {"X_DPAD_UP", OWC::Button::X_DPAD_UP},
-        {"X_DPAD_DOWN", OWC::Button::X_DPAD_DOWN},
-        {"X_DPAD_LEFT", OWC::Button::X_DPAD_LEFT},
-        {"X_DPAD_RIGHT", OWC::Button::X_DPAD_RIGHT},
-        {"X_L_ANALOG_UP", OWC::Button::X_LANALOG_UP},
-        {"X_L_ANALOG_DOWN", OWC::Button::X_LANALOG_DOWN},
-        {"X_L_ANALOG_LEFT", OWC::Button::X_LANALOG_LEFT},
-        {"X_L_ANALOG_RIGHT", OWC::Button::X_LANALOG_RIGHT},
-        {"X_R_ANALOG_UP", OWC::Button::X_RANALOG_UP},
-        {"X_R_ANALOG_DOWN", OWC::Button::X_RANALOG_DOWN},
-        {"X_R_ANALOG_LEFT", OWC::Button::X_RANALOG_LEFT},
-        {"X_R_ANALOG_RIGHT", OWC::Button::X_RANALOG_RIGHT},
-        {"X_L1", OWC::Button::X_L1},
-        {"X_L2", OWC::Button::X_L2},
-        {"X_L3", OWC::Button::X_L3},
-        {"X_R1", OWC::Button::X_R1},
-        {"X_R2", OWC::Button::X_R2},
-        {"X_R3", OWC::Button::X_R3},
-        {"X_START", OWC::Button::X_START},
-        {"X_SELECT", OWC::Button::X_SELECT},
-        {"X_MENU", OWC::Button::X_MENU}
+    static constexpr std::array<std::pair<std::string_view, OWC::Button>, 25> xinputLabels = {{
+        {"DPAD Up:\t\t", OWC::Button::X_DPAD_UP},
+        {"DPAD Down:\t\t", OWC::Button::X_DPAD_DOWN},
+        {"DPAD Left:\t\t", OWC::Button::X_DPAD_LEFT},
+        {"DPAD Right:\t\t", OWC::Button::X_DPAD_RIGHT},
+        {"A:\t\t\t", OWC::Button::X_A},
+        {"B:\t\t\t", OWC::Button::X_B},
+        {"X:\t\t\t", OWC::Button::X_X},
+        {"Y:\t\t\t", OWC::Button::X_Y},
+        {"Start:\t\t\t", OWC::Button::X_START},
+        {"Select:\t\t\t", OWC::Button::X_SELECT},
+        {"Menu:\t\t\t", OWC::Button::X_MENU},
+        {"Left Analog Up:\t\t", OWC::Button::X_LANALOG_UP},
+        {"Left Analog Down:\t", OWC::Button::X_LANALOG_DOWN},
+        {"Left Analog Left:\t", OWC::Button::X_LANALOG_LEFT},
+        {"Left Analog Right:\t", OWC::Button::X_LANALOG_RIGHT},
+        {"Right Analog Up:\t", OWC::Button::X_RANALOG_UP},
+        {"Right Analog Down:\t", OWC::Button::X_RANALOG_DOWN},
+        {"Right Analog Left:\t", OWC::Button::X_RANALOG_LEFT},
+        {"Right Analog Right:\t", OWC::Button::X_RANALOG_RIGHT},
+        {"L1:\t\t\t", OWC::Button::X_L1},
+        {"L2:\t\t\t", OWC::Button::X_L2},
+        {"L3:\t\t\t", OWC::Button::X_L3},
+        {"R1:\t\t\t", OWC::Button::X_R1},
+        {"R2:\t\t\t", OWC::Button::X_R2},
+        {"R3:\t\t\t", OWC::Button::X_R3}
     }};
 
-    static constexpr std::array<std::tuple<std::string_view, OWC::Button, std::string_view>, 21> keyArgs = {{
-        {"du", OWC::Button::KBD_DPAD_UP, "dpad up"},
-        {"dd", OWC::Button::KBD_DPAD_DOWN, "dpad down"},
-        {"dl", OWC::Button::KBD_DPAD_LEFT, "dpad left"},
-        {"dr", OWC::Button::KBD_DPAD_RIGHT, "dpad right"},
-        {"a",  OWC::Button::KBD_A, "A"},
-        {"b",  OWC::Button::KBD_B, "B"},
-        {"x",  OWC::Button::KBD_X, "X"},
-        {"y",  OWC::Button::KBD_Y, "Y"},
-        {"lu", OWC::Button::KBD_LANALOG_UP, "left analog up"},
-        {"ld", OWC::Button::KBD_LANALOG_DOWN, "left analog down"},
-        {"ll", OWC::Button::KBD_LANALOG_LEFT, "left analog left"},
-        {"lr", OWC::Button::KBD_LANALOG_RIGHT, "left analog right"},
-        {"st", OWC::Button::KBD_START, "start"},
-        {"sl", OWC::Button::KBD_SELECT, "select"},
-        {"mu", OWC::Button::KBD_MENU, "menu"},
-        {"l1", OWC::Button::KBD_L1, "L1"},
-        {"l2", OWC::Button::KBD_L2, "L2"},
-        {"l3", OWC::Button::KBD_L3, "L3"},
-        {"r1", OWC::Button::KBD_R1, "R1"},
-        {"r2", OWC::Button::KBD_R2, "R2"},
-        {"r3", OWC::Button::KBD_R3, "R3"}
-    }};
+    [[nodiscard]]
+    static bool hasSection(const PrintFilter &filter, const OWC::PrintSection section) {
+        return filter.sections & (1 << static_cast<int>(section));
+    }
 
-    static constexpr std::array<std::tuple<std::string_view, OWC::Button, std::string_view>, 25> xkeyArgs = {{
-        {"xdu", OWC::Button::X_DPAD_UP, "xinput dpad up"},
-        {"xdd", OWC::Button::X_DPAD_DOWN, "xinput dpad down"},
-        {"xdl", OWC::Button::X_DPAD_LEFT, "xinput dpad left"},
-        {"xdr", OWC::Button::X_DPAD_RIGHT, "xinput dpad right"},
-        {"xa",  OWC::Button::X_A, "xinput A"},
-        {"xb",  OWC::Button::X_B, "xinput B"},
-        {"xx",  OWC::Button::X_X, "xinput X"},
-        {"xy",  OWC::Button::X_Y, "xinput Y"},
-        {"xlu", OWC::Button::X_LANALOG_UP, "xinput left analog up"},
-        {"xld", OWC::Button::X_LANALOG_DOWN, "xinput left analog down"},
-        {"xll", OWC::Button::X_LANALOG_LEFT, "xinput left analog left"},
-        {"xlr", OWC::Button::X_LANALOG_RIGHT, "xinput left analog right"},
-        {"xru", OWC::Button::X_RANALOG_UP, "xinput right analog up"},
-        {"xrd", OWC::Button::X_RANALOG_DOWN, "xinput right analog down"},
-        {"xrl", OWC::Button::X_RANALOG_LEFT, "xinput right analog left"},
-        {"xrr", OWC::Button::X_RANALOG_RIGHT, "xinput right analog right"},
-        {"xst", OWC::Button::X_START, "xinput start"},
-        {"xsl", OWC::Button::X_SELECT, "xinput select"},
-        {"xmu", OWC::Button::X_MENU, "xinput menu"},
-        {"xl1", OWC::Button::X_L1, "xinput L1"},
-        {"xl2", OWC::Button::X_L2, "xinput L2"},
-        {"xl3", OWC::Button::X_L3, "xinput L3"},
-        {"xr1", OWC::Button::X_R1, "xinput R1"},
-        {"xr2", OWC::Button::X_R2, "xinput R2"},
-        {"xr3", OWC::Button::X_R3, "xinput R3"}
-    }};
+    static void printControllerInfoV1(const OWC::DeviceState &state, std::string &out) {
+        const auto [xmaj, xmin] = state.xVersion;
+        const auto [kmaj, kmin] = state.kVersion;
 
-    static std::array<std::pair<std::string_view, bool>, 4> getControllerV2BackButtons(const std::shared_ptr<OWC::Controller> &gpd) {
-        return {
-            std::make_pair("L4", true),
-            std::make_pair("R4", true),
-            std::make_pair("L5", gpd->hasFeature(OWC::ControllerFeature::BackButton3)),
-            std::make_pair("R5", gpd->hasFeature(OWC::ControllerFeature::BackButton4))
-        };
+        std::format_to(std::back_inserter(out), "=== Controller V1 Info ===\n\n"
+            "Xinput Version:\t\t{:x}.{:x}\n"
+            "Keyboard&Mouse Version:\t{:x}.{:x}\n", xmaj, xmin, kmaj, kmin);
     }
 
-    static void printControllerInfoV1(const std::shared_ptr<OWC::ControllerV1> &gpd) {
-        const auto [xmaj, xmin] = gpd->getXVersion();
-        const auto [kmaj, kmin] = gpd->getKVersion();
-
-        std::cout << "=== Controller V1 Info ===\n\n"
-            "Xinput Version:\t\t" << std::hex << xmaj << "." << xmin << "\n" <<
-            "Keyboard&Mouse Version:\t" << kmaj << "." << kmin << std::dec << "\n";
-    }
-
-    static void printControllerInfoV2(const std::shared_ptr<OWC::ControllerV2> &gpd) {
-        const auto [major, minor] = gpd->getVersion();
-
-        std::cout << "=== Controller V2 Info ===\n\n"
-            "Version:\t\t" << std::hex << major << "." << minor << std::dec << "\n"
-            "Emulation Mode:\t\t" << OWC::emulationModeToString(gpd->getEmulationMode()) << "\n";
-    }
-
-    static void printKeyboardMouseMapping(const std::shared_ptr<OWC::Controller> &gpd) {
-        std::cout << "\n=== Keyboard&Mouse Mapping ===\n\n" <<
-            "DPAD Up:\t\t" << gpd->getButton(OWC::Button::KBD_DPAD_UP) << "\n"
-            "DPAD Down:\t\t" << gpd->getButton(OWC::Button::KBD_DPAD_DOWN) << "\n"
-            "DPAD Left:\t\t" << gpd->getButton(OWC::Button::KBD_DPAD_LEFT) << "\n"
-            "DPAD Right:\t\t" << gpd->getButton(OWC::Button::KBD_DPAD_RIGHT) << "\n"
-            "A:\t\t\t" << gpd->getButton(OWC::Button::KBD_A) << "\n"
-            "B:\t\t\t" << gpd->getButton(OWC::Button::KBD_B) << "\n"
-            "X:\t\t\t" << gpd->getButton(OWC::Button::KBD_X) << "\n"
-            "Y:\t\t\t" << gpd->getButton(OWC::Button::KBD_Y) << "\n"
-            "Start:\t\t\t" << gpd->getButton(OWC::Button::KBD_START) << "\n"
-            "Select:\t\t\t" << gpd->getButton(OWC::Button::KBD_SELECT) << "\n"
-            "Menu:\t\t\t" << gpd->getButton(OWC::Button::KBD_MENU) << "\n"
-            "Left Analog Up:\t\t" << gpd->getButton(OWC::Button::KBD_LANALOG_UP) << "\n"
-            "Left Analog Down:\t" << gpd->getButton(OWC::Button::KBD_LANALOG_DOWN) << "\n"
-            "Left Analog Left:\t" << gpd->getButton(OWC::Button::KBD_LANALOG_LEFT) << "\n"
-            "Left Analog Right:\t" << gpd->getButton(OWC::Button::KBD_LANALOG_RIGHT) << "\n"
-            "L1:\t\t\t" << gpd->getButton(OWC::Button::KBD_L1) << "\n"
-            "L2:\t\t\t" << gpd->getButton(OWC::Button::KBD_L2) << "\n"
-            "L3:\t\t\t" << gpd->getButton(OWC::Button::KBD_L3) << "\n"
-            "R1:\t\t\t" << gpd->getButton(OWC::Button::KBD_R1) << "\n"
-            "R2:\t\t\t" << gpd->getButton(OWC::Button::KBD_R2) << "\n"
-            "R3:\t\t\t" << gpd->getButton(OWC::Button::KBD_R3) << "\n";
-    }
-
-    static void printXinputMapping(const std::shared_ptr<OWC::Controller> &gpd) {
+    static void printControllerInfoV2(const OWC::DeviceState &state, std::string &out) {
+        const auto [major, minor] = state.version;
+
+        std::format_to(std::back_inserter(out), "=== Controller V2 Info ===\n\n"
+            "Version:\t\t{:x}.{:x}\n"
+            "Emulation Mode:\t\t{}\n", major, minor, OWC::emulationModeToString(static_cast<OWC::EmulationMode>(state.emulationMode)));
+    }
+
+    static void printKeyboardMouseMapping(const std::shared_ptr<OWC::Controller> &gpd, std::string &out) {
+        out += "\n=== Keyboard&Mouse Mapping ===\n\n";
+
+        for (const auto &[label, btn]: kbmLabels)
+            std::format_to(std::back_inserter(out), "{}{}\n", label, gpd->getButton(btn));
+    }
+
+    static void printXinputMapping(const std::shared_ptr<OWC::Controller> &gpd, std::string &out) {
         if (!gpd->hasFeature(OWC::ControllerFeature::XinputMappingV1))
             return;
 
-        std::cout << "\n=== Xinput Mapping ===\n\n" <<
-            "DPAD Up:\t\t" << gpd->getButton(OWC::Button::X_DPAD_UP) << "\n"
-            "DPAD Down:\t\t" << gpd->getButton(OWC::Button::X_DPAD_DOWN) << "\n"
-            "DPAD Left:\t\t" << gpd->getButton(OWC::Button::X_DPAD_LEFT) << "\n"
-            "DPAD Right:\t\t" << gpd->getButton(OWC::Button::X_DPAD_RIGHT) << "\n"
-            "A:\t\t\t" << gpd->getButton(OWC::Button::X_A) << "\n"
-            "B:\t\t\t" << gpd->getButton(OWC::Button::X_B) << "\n"
-            "X:\t\t\t" << gpd->getButton(OWC::Button::X_X) << "\n"
-            "Y:\t\t\t" << gpd->getButton(OWC::Button::X_Y) << "\n"
-            "Start:\t\t\t" << gpd->getButton(OWC::Button::X_START) << "\n"
-            "Select:\t\t\t" << gpd->getButton(OWC::Button::X_SELECT) << "\n"
-            "Menu:\t\t\t" << gpd->getButton(OWC::Button::X_MENU) << "\n"
-            "Left Analog Up:\t\t" << gpd->getButton(OWC::Button::X_LANALOG_UP) << "\n"
-            "Left Analog Down:\t" << gpd->getButton(OWC::Button::X_LANALOG_DOWN) << "\n"
-            "Left Analog Left:\t" << gpd->getButton(OWC::Button::X_LANALOG_LEFT) << "\n"
-            "Left Analog Right:\t" << gpd->getButton(OWC::Button::X_LANALOG_RIGHT) << "\n"
-            "Right Analog Up:\t" << gpd->getButton(OWC::Button::X_RANALOG_UP) << "\n"
-            "Right Analog Down:\t" << gpd->getButton(OWC::Button::X_RANALOG_DOWN) << "\n"
-            "Right Analog Left:\t" << gpd->getButton(OWC::Button::X_RANALOG_LEFT) << "\n"
-            "Right Analog Right:\t" << gpd->getButton(OWC::Button::X_RANALOG_RIGHT) << "\n"
-            "L1:\t\t\t" << gpd->getButton(OWC::Button::X_L1) << "\n"
-            "L2:\t\t\t" << gpd->getButton(OWC::Button::X_L2) << "\n"
-            "L3:\t\t\t" << gpd->getButton(OWC::Button::X_L3) << "\n"
-            "R1:\t\t\t" << gpd->getButton(OWC::Button::X_R1) << "\n"
-            "R2:\t\t\t" << gpd->getButton(OWC::Button::X_R2) << "\n"
-            "R3:\t\t\t" << gpd->getButton(OWC::Button::X_R3) << "\n";
-    }
-
-    static void printBackButtonsV1(const std::shared_ptr<OWC::Controller> &gpd) {
-        int num = 1;
-
-        for (const std::string_view btn: {"L4", "R4"}) {
-            std::cout << "\n=== " << btn << " Back Button Macro ===\n\n"
-
-                "Key 1:\t\t\t" << gpd->getBackButton(num, 1) << "\n"
-                "Key 1 Start Time:\t" << gpd->getBackButtonStartTime(num, 1) << "\n"
-                "Key 2:\t\t\t" << gpd->getBackButton(num, 2) << "\n"
-                "Key 2 Start Time:\t" << gpd->getBackButtonStartTime(num, 2) << "\n"
-                "Key 3:\t\t\t" << gpd->getBackButton(num, 3) << "\n"
-                "Key 3 Start Time:\t" << gpd->getBackButtonStartTime(num, 3) << "\n"
-                "Key 4:\t\t\t" << gpd->getBackButton(num, 4) << "\n"
-                "Macro Start Time:\t" << gpd->getBackButtonStartTime(num, 4) << "\n";
-
-            ++num;
-        }
-    }
-
-    static void printBackButtonsV2(const std::shared_ptr<OWC::ControllerV2> &gpd) {
-        int num = 1;
-
-        for (const std::string_view btn: {"L4", "R4", "L5", "R5"}) {
-            std::cout << "\n=== " << btn << " Back Button ===\n\n"
-
-                "Button Mode:\t" << OWC::backButtonModeToString(gpd->getBackButtonMode(num)) << "\n"
-                "Active slots:\t" << gpd->getBackButtonActiveSlots(num) << "\n\n";
-
-            for (int i=1; i<=32; ++i) {
-                std::cout << "Key " << i << ":\t\t\t" << gpd->getBackButton(num, i) << "\n"
-                    "Key " << i << " Start Time:\t" << gpd->getBackButtonStartTime(num, i) << "\n"
-                    "Key " << i << " Hold Time:\t" << gpd->getBackButtonHoldTime(num, i) << "\n";
-            }
+        out += "\n=== Xinput Mapping ===\n\n";
+
+        for (const auto &[label, btn]: xinputLabels)
+            std::format_to(std::back_inserter(out), "{}{}\n", label, gpd->getButton(btn));
+    }
+
+    static void printBackButtonsV1(const std::shared_ptr<OWC::Controller> &gpd, const PrintFilter &filter, std::string &out) {
+        for (int num=1; num<=2; ++num) {
+            if (filter.button != 0 && filter.button != num)
+                continue;
 
-            ++num;
+            std::format_to(std::back_inserter(out), "\n=== {} Back Button Macro ===\n\n", OWC::BackButtonNames[num - 1]);
+
+            for (int i=1; i<=3; ++i)
+                std::format_to(std::back_inserter(out), "Key {0}:\t\t\t{1}\nKey {0} Start Time:\t{2}\n", i, gpd->getBackButton(num, i), gpd->getBackButtonStartTime(num, i));
+
+            std::format_to(std::back_inserter(out), "Key 4:\t\t\t{}\nMacro Start Time:\t{}\n", gpd->getBackButton(num, 4), gpd->getBackButtonStartTime(num, 4));
         }
     }
 
-    static void printRumbleV1(const std::shared_ptr<OWC::Controller> &gpd) {
+    static void printBackButtonsV2(const std::shared_ptr<OWC::ControllerV2> &gpd, const OWC::DeviceState &state, const PrintFilter &filter, std::string &out) {
+        for (int num=1; num<=4; ++num) {
+            if (filter.button != 0 && filter.button != num)
+                continue;
+
+            const int activeSlots = gpd->getBackButtonActiveSlots(num);
+            const int slots = filter.activeOnly ? std::clamp(activeSlots, 0, 32) : 32;
+
+            std::format_to(std::back_inserter(out), "\n=== {} Back Button ===\n\n"
+                "Button Mode:\t{}\n"
+                "Active slots:\t{}\n\n", OWC::BackButtonNames[num - 1], OWC::backButtonModeToString(static_cast<OWC::BackButtonMode>(state.backButtonModes[num - 1])), activeSlots);
+
+            for (int i=1; i<=slots; ++i) {
+                std::format_to(std::back_inserter(out), "Key {0}:\t\t\t{1}\n"
+                    "Key {0} Start Time:\t{2}\n"
+                    "Key {0} Hold Time:\t{3}\n", i, gpd->getBackButton(num, i), gpd->getBackButtonStartTime(num, i), gpd->getBackButtonHoldTime(num, i));
+            }
+        }
+    }
+
+    static void printRumbleV1(const std::shared_ptr<OWC::Controller> &gpd, std::string &out) {
         if (!gpd->hasFeature(OWC::ControllerFeature::RumbleV1))
             return;
 
-        std::cout << "\n=== Rumble ===\n\n"
-            "Vibration intensity:\t" << OWC::rumbleModeToString(gpd->getRumbleMode()) << "\n";
+        std::format_to(std::back_inserter(out), "\n=== Rumble ===\n\n"
+            "Vibration intensity:\t{}\n", OWC::rumbleModeToString(gpd->getRumbleMode()));
     }
 
-    static void printDeadzoneControlV1(const std::shared_ptr<OWC::Controller> &gpd) {
+    static void printDeadzoneControlV1(const std::shared_ptr<OWC::Controller> &gpd, std::string &out) {
         if (!gpd->hasFeature(OWC::ControllerFeature::DeadZoneControlV1))
             return;
 
-        std::cout << "\n=== Calibration/Deadzone ===\n\n"
-            "Left Analog deadzone:\t" << gpd->getAnalogCenter(true) << "\n"
-            "Left Analog boundary:\t" << gpd->getAnalogBoundary(true) << "\n"
-            "Right Analog deadzone:\t" << gpd->getAnalogCenter(false) << "\n"
-            "Right Analog boundary:\t" << gpd->getAnalogBoundary(false) << "\n";
+        std::format_to(std::back_inserter(out), "\n=== Calibration/Deadzone ===\n\n"
+            "Left Analog deadzone:\t{}\n"
+            "Left Analog boundary:\t{}\n"
+            "Right Analog deadzone:\t{}\n"
+            "Right Analog boundary:\t{}\n", gpd->getAnalogCenter(true), gpd->getAnalogBoundary(true), gpd->getAnalogCenter(false), gpd->getAnalogBoundary(false));
     }
 
-    static void printShoulderLedsV1(const std::shared_ptr<OWC::Controller> &gpd) {
+    static void printShoulderLedsV1(const std::shared_ptr<OWC::Controller> &gpd, std::string &out) {
         if (!gpd->hasFeature(OWC::ControllerFeature::ShoulderLedsV1))
             return;
 
         const OWC::LedMode mode = gpd->getLedMode();
 
-        std::cout << "\n=== Shoulder LEDs ===\n\n"
-            "Mode:\t\t\t" << OWC::ledModeToString(mode) << "\n";
+        std::format_to(std::back_inserter(out), "\n=== Shoulder LEDs ===\n\n"
+            "Mode:\t\t\t{}\n", OWC::ledModeToString(mode));
 
         if (mode != OWC::LedMode::Off && mode != OWC::LedMode::Rotate) {
-            const std::tuple<int, int, int> color = gpd->getLedColor();
+            const auto [r, g, b] = gpd->getLedColor();
 
-            std::cout << "Color:\t\t\t"
-                "R(" << std::get<0>(color) << "), "
-                "G(" << std::get<1>(color) << "), "
-                "B(" << std::get<2>(color) << ")\n";
+            std::format_to(std::back_inserter(out), "Color:\t\t\tR({}), G({}), B({})\n", r, g, b);
         }
     }
 
-    void printCurrentSettings(const std::shared_ptr<OWC::Controller> &gpd) {
+    PrintFilter getPrintFilter(const OWC::CMDParser &cmd) {
+        PrintFilter filter;
+
+        if (cmd.hasArg("--section"))
+            filter.sections = std::get<int>(cmd.getValue("--section"));
+        else if (cmd.hasArg("--button"))
+            filter.sections = 1 << static_cast<int>(OWC::PrintSection::BackButtons);
+
+        if (cmd.hasArg("--button"))
+            filter.button = std::get<int>(cmd.getValue("--button"));
+
+        filter.activeOnly = cmd.hasArg("--active-only");
+        return filter;
+    }
+
+    void printCurrentSettings(const std::shared_ptr<OWC::Controller> &gpd, const PrintFilter &filter) {
+        const OWC::TraceSpan span ("print");
+        const OWC::DeviceState &state = OWC::DeviceSession::getInstance()->getState();
         const int controllerType = gpd->getControllerType();
+        std::string out;
+
+        // the whole V2 report is ~12KB
+        out.reserve(16384);
 
         if (controllerType == 1) {
-            const std::shared_ptr<OWC::ControllerV1> gpdV1 = std::dynamic_pointer_cast<OWC::ControllerV1>(gpd);
+            if (hasSection(filter, OWC::PrintSection::Info))
+                printControllerInfoV1(state, out);
+
+            if (hasSection(filter, OWC::PrintSection::KeyboardMouse))
+                printKeyboardMouseMapping(gpd, out);
 
-            printControllerInfoV1(gpdV1);
-            printKeyboardMouseMapping(gpd);
-            printBackButtonsV1(gpd);
+            if (hasSection(filter, OWC::PrintSection::BackButtons))
+                printBackButtonsV1(gpd, filter, out);
 
         } else if (controllerType == 2) {
             const std::shared_ptr<OWC::ControllerV2> gpdV2 = std::dynamic_pointer_cast<OWC::ControllerV2>(gpd);
 
-            printControllerInfoV2(gpdV2);
-            printKeyboardMouseMapping(gpd);
-            printXinputMapping(gpd);
-            printBackButtonsV2(gpdV2);
-        }
+            if (hasSection(filter, OWC::PrintSection::Info))
+                printControllerInfoV2(state, out);
 
-        printRumbleV1(gpd);
-        printDeadzoneControlV1(gpd);
-        printShoulderLedsV1(gpd);
-    }
+            if (hasSection(filter, OWC::PrintSection::KeyboardMouse))
+                printKeyboardMouseMapping(gpd, out);
 
-    static void exportBackButtonsV1Yaml(const std::shared_ptr<OWC::Controller> &gpd, std::ofstream &ofs) {
-        int num = 1;
+            if (hasSection(filter, OWC::PrintSection::Xinput))
+                printXinputMapping(gpd, out);
 
-        for (const std::string_view btn: {"L4", "R4"}) {
-            for (int i=1; i<=4; ++i) {
-                ofs << btn << "_K" << i << ": " << gpd->getBackButton(num, i) << "\n";
+            if (hasSection(filter, OWC::PrintSection::BackButtons))
+                printBackButtonsV2(gpdV2, state, filter, out);
+        }
 
-                if (i < 4)
-                    ofs << btn << "_k" << i << "_START_TIME: " << gpd->getBackButtonStartTime(num, i) << "\n";
-            }
+        if (hasSection(filter, OWC::PrintSection::Rumble))
+            printRumbleV1(gpd, out);
 
-            ++num;
-        }
+        if (hasSection(filter, OWC::PrintSection::DeadZone))
+            printDeadzoneControlV1(gpd, out);
 
-        ofs << "L4_MACRO_START_TIME: " << gpd->getBackButtonStartTime(1, 4) << "\n"
-            "R4_MACRO_START_TIME: " << gpd->getBackButtonStartTime(2, 4) << "\n";
-    }
+        if (hasSection(filter, OWC::PrintSection::Leds))
+            printShoulderLedsV1(gpd, out);
 
-    static void exportBackButtonsV2Yaml(const std::shared_ptr<OWC::ControllerV2> &gpd, std::ofstream &ofs) {
-        int num = 0;
+        // sections are separated by a leading blank line
+        if (!hasSection(filter, OWC::PrintSection::Info) && out.starts_with('\n'))
+            out.erase(0, 1);
 
-        for (const auto [btn, implemented]: getControllerV2BackButtons(gpd)) {
-            ++num;
+        std::cout.write(out.data(), out.size());
+    }
 
-            if (!implemented)
-                continue;
+    int exportProfile(const std::shared_ptr<OWC::Controller> &gpd, const std::string &fileName, const bool sync) {
+        const OWC::TraceSpan span ("export");
 
-            for (int i=1; i<=32; ++i) {
-                ofs << btn << "_K" << i <<": " << gpd->getBackButton(num, i) << "\n" <<
-                    btn << "_K" << i << "_START_TIME: " << gpd->getBackButtonStartTime(num, i) << "\n" <<
-                    btn << "_K" << i << "_HOLD_TIME: " << gpd->getBackButtonHoldTime(num, i) << "\n";
-            }
+        if (!OWC::ProfileWriter::write(OWC::ConfigImage::capture(gpd), fileName, sync))
+            return 1;
 
-            ofs << btn << "_ACTIVE_SLOTS: " << gpd->getBackButtonActiveSlots(num) << "\n";
-        }
+        // stdout is the profile
+        if (fileName != "-")
+            std::cout << "exported config to " << fileName << "\n";
+
+        return 0;
     }
 
-    int exportToYaml(const std::shared_ptr<OWC::Controller> &gpd, const std::string &fileName) {
-        const int controllerType = gpd->getControllerType();
-        std::ofstream yaml (fileName);
+    int applyProfile(const std::shared_ptr<OWC::Controller> &gpd, const std::string &fileName) {
+        const OWC::TraceSpan span ("applyProfile");
+        OWC::ConfigImage profile;
 
-        if (!yaml.is_open()) {
-            std::cerr << "failed to open " << fileName <<" for write\n";
+        if (OWC::ProfileReader::read(fileName, gpd->getControllerType(), profile) != OWC::ProfileReader::Result::Ok)
             return 1;
-        }
 
-        yaml << "MAPPING_TYPE: " << controllerType << "\n";
+        profile.apply(gpd);
+        return 0;
+    }
 
-        // keyboard&mouse mapping
-        for (const auto &[key, btn]: kbmKeys)
-            yaml << std::format("{}: ", key) << gpd->getButton(btn) << "\n";
+    int importProfile(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const OWC::ConfigImage &profile, const std::string &fileName) {
+        profile.apply(gpd);
 
-        if (gpd->hasFeature(OWC::ControllerFeature::XinputMappingV1)) {
-            for (const auto &[key, btn]: xinptKeys)
-                yaml << std::format("{}: ", key) << gpd->getButton(btn) << "\n";
-        }
+        if (commitConfig(gpd, shadow) != 0)
+            return 1;
 
-        if (controllerType == 1) {
-            exportBackButtonsV1Yaml(gpd, yaml);
+        std::cout << "applied config from " << fileName << "\n";
+        return 0;
+    }
 
-        } else if (controllerType == 2) {
-            const std::shared_ptr<OWC::ControllerV2> gpdV2 = std::dynamic_pointer_cast<OWC::ControllerV2>(gpd);
+    int convertProfile(const std::string &inFile, const std::string &outFile, const bool sync) {
+        const OWC::TraceSpan span ("convert");
+        OWC::ConfigImage profile;
+
+        try {
+            if (OWC::ProfileReader::read(inFile, 0, profile) != OWC::ProfileReader::Result::Ok)
+                return 1;
 
-            exportBackButtonsV2Yaml(gpdV2, yaml);
+        } catch (const YAML::Exception &yex) {
+            std::cerr << "failed to parse yaml: " << yex.msg << "\n";
+            return 1;
         }
 
-        yaml.close();
-        std::cout << "exported config to " << fileName << "\n";
+        if (!OWC::ProfileWriter::write(profile, outFile, sync))
+            return 1;
+
+        if (outFile != "-")
+            std::cout << "converted " << inFile << " to " << outFile << "\n";
+
         return 0;
     }
 
-    static void importBackButtonsV1Yaml(const std::shared_ptr<OWC::Controller> &gpd, const YAML::Node &yaml) {
-        int num = 1;
+    static int reportResults(const std::vector<OWC::ProfileResult> &results, const std::string &report, const std::string_view verb) {
+        std::array<int, 3> counts {};
+
+        for (const OWC::ProfileResult &res: results) {
+            const std::string_view status = OWC::ProfileValidator::status(res);
 
-        for (const std::string_view btn: {"L4", "R4"}) {
-            for (int i=1; i<=4; ++i) {
-                const std::string key = std::format("{}_K{}", btn, i);
-                std::string keyCode = yaml[key].as<std::string>();
+            for (const std::string &msg: res.errors)
+                std::cerr << res.path << ": error: " << msg << "\n";
 
-                std::transform(keyCode.begin(), keyCode.end(), keyCode.begin(), ::toupper);
+            for (const std::string &msg: res.warnings)
+                std::cerr << res.path << ": warning: " << msg << "\n";
 
-                if (yaml[key] && !gpd->setBackButton(num, i, keyCode))
-                    std::cerr << "failed to set " << key << "\n";
+            ++counts[status == "ok" ? 0 : (status == "warning" ? 1 : 2)];
+        }
 
-                if (i < 4) {
-                    const std::string time = std::format("{}_K{}_START_TIME", btn, i);
+        if (report == "-") {
+            std::cout << OWC::ProfileValidator::toJson(results);
 
-                    if (yaml[time])
-                        gpd->setBackButtonStartTime(num, i, yaml[time].as<int>());
-                }
-            }
+        } else if (!report.empty()) {
+            std::ofstream ofs (report, std::ios::trunc);
+
+            ofs << OWC::ProfileValidator::toJson(results);
+            ofs.close();
 
-            ++num;
+            if (ofs.fail()) {
+                std::cerr << "failed to write report " << report << "\n";
+                return 1;
+            }
         }
 
-        if (yaml["L4_MACRO_START_TIME"])
-            gpd->setBackButtonStartTime(1, 4, yaml["L4_MACRO_START_TIME"].as<int>());
+        // keep stdout clean for the json report
+        (report == "-" ? std::cerr : std::cout) << std::format("{} {} profiles: {} ok, {} with warnings, {} with errors\n",
+            verb, results.size(), counts[0], counts[1], counts[2]);
 
-        if (yaml["R4_MACRO_START_TIME"])
-            gpd->setBackButtonStartTime(2, 4, yaml["R4_MACRO_START_TIME"].as<int>());
+        return counts[2] > 0 ? 1 : 0;
     }
 
-    static void importBackButtonsV2Yaml(const std::shared_ptr<OWC::ControllerV2> &gpd, const YAML::Node &yaml) {
-        int num = 0;
+    BulkOptions getBulkOptions(const OWC::CMDParser &cmd) {
+        BulkOptions opts;
 
-        for (const auto [btn, implemented]: getControllerV2BackButtons(gpd)) {
-            ++num;
+        if (cmd.hasArg("--to"))
+            opts.format = std::get<std::string_view>(cmd.getValue("--to"));
 
-            if (!implemented)
-                continue;
+        if (cmd.hasArg("--report"))
+            opts.report = std::get<std::string_view>(cmd.getValue("--report"));
+
+        if (cmd.hasArg("--jobs"))
+            opts.jobs = std::get<int>(cmd.getValue("--jobs"));
+
+        opts.sync = cmd.hasArg("--fsync");
+        return opts;
+    }
+
+    int validateProfiles(const std::vector<std::string> &paths, const BulkOptions &opts) {
+        const OWC::TraceSpan span ("validate");
+        const std::vector<std::string> files = OWC::ProfileValidator::collect(paths);
+        std::vector<OWC::ProfileResult> results (files.size());
+
+        OWC::WorkPool::run(files.size(), opts.jobs ? opts.jobs : OWC::WorkPool::defaultJobs(), [&files, &results](const size_t i) {
+            results[i] = OWC::ProfileValidator::validate(files[i]);
+        });
 
-            const std::string activeC = std::format("{}_ACTIVE_SLOTS", btn);
+        return reportResults(results, opts.report, "validated");
+    }
 
-            for (int i=1; i<=32; ++i) {
-                const std::string key = std::format("{}_K{}", btn, i);
-                const std::string time = std::format("{}_K{}_START_TIME", btn, i);
-                const std::string hold = std::format("{}_K{}_HOLD_TIME", btn, i);
-                std::string kc = yaml[key].as<std::string>();
+    int convertProfiles(const std::string &inDir, const std::string &outDir, const BulkOptions &opts) {
+        const OWC::TraceSpan span ("convert");
+        const std::vector<std::string> files = OWC::ProfileValidator::collect({inDir});
+        std::vector<OWC::ProfileResult> results (files.size());
+        std::vector<std::string> outFiles;
+        std::unordered_map<std::string, size_t> outOwners;
 
-                std::transform(kc.begin(), kc.end(), kc.begin(), ::toupper);
+        outFiles.reserve(files.size());
 
-                if (yaml[key] && !gpd->setBackButton(num, i, kc))
-                    std::cerr << "failed to set " << key << "\n";
+        // create the output tree up front, workers only write files
+        for (const std::string &file: files) {
+            std::filesystem::path out = std::filesystem::path(outDir) / std::filesystem::path(file).lexically_relative(inDir);
+            const bool toBinary = opts.format.empty() ? !OWC::ProfileWriter::isBinaryName(file) : opts.format == "owcb";
+            std::error_code ec;
 
-                if (yaml[time])
-                    gpd->setBackButtonStartTime(num, i, yaml[time].as<int>());
+            out.replace_extension(toBinary ? ".owcb" : ".yaml");
+            std::filesystem::create_directories(out.parent_path(), ec);
 
-                if (yaml[hold])
-                    gpd->setBackButtonHoldTime(num, i, yaml[hold].as<int>());
+            if (ec) {
+                std::cerr << "failed to create " << out.parent_path().string() << ": " << ec.message() << "\n";
+                return 1;
             }
 
-            if (yaml[activeC])
-                gpd->setBackButtonActiveSlots(num, std::clamp(yaml[activeC].as<int>(), 0, 32));
+            outFiles.push_back(out.lexically_normal().string());
+
+            // a.yaml and a.yml, or a.yaml and a.owcb with --to owcb, would write the same file from two workers
+            if (const auto [it, added] = outOwners.emplace(outFiles.back(), outFiles.size() - 1); !added) {
+                for (const size_t i: {it->second, outFiles.size() - 1}) {
+                    results[i].path = files[i];
+                    results[i].output = outFiles[i];
+                    results[i].errors.push_back(std::format("output {} is also the output of {}", outFiles[i], files[i == it->second ? outFiles.size() - 1 : it->second]));
+                }
+            }
         }
+
+        OWC::WorkPool::run(files.size(), opts.jobs ? opts.jobs : OWC::WorkPool::defaultJobs(), [&files, &outFiles, &results, &opts](const size_t i) {
+            if (results[i].errors.empty())
+                results[i] = OWC::ProfileValidator::convert(files[i], outFiles[i], opts.sync);
+        });
+
+        return reportResults(results, opts.report, "converted");
     }
 
-    int importFromYaml(const std::shared_ptr<OWC::Controller> &gpd, const std::string &fileName) {
-        const int controllerType = gpd->getControllerType();
-        const YAML::Node yaml = YAML::LoadFile(fileName);
+    int simulateMacro(const OWC::ConfigImage &img, const OWC::CMDParser &cmd) {
+        const int num = std::get<int>(cmd.getValue("simulate"));
+        OWC::MacroTimeline timeline;
 
-        if (!yaml.IsMap()) {
-            std::cerr << "invalid yaml file\n";
+        if (img.controllerType == 1) {
+            std::cerr << "simulate needs V2 slots, V1 macros have no hold times\n";
             return 1;
-        }
 
-        if (!yaml["MAPPING_TYPE"]) {
-            std::cerr << "mapping type missing, cannot apply mapping\n";
+        } else if (!timeline.build(img, num)) {
+            std::cerr << OWC::BackButtonNames[num - 1] << " has no macro slots on this controller\n";
             return 1;
+        }
+
+        std::cout << (cmd.hasArg("--json") ? timeline.toJson() : timeline.toText());
+        return 0;
+    }
 
-        } else if (yaml["MAPPING_TYPE"].as<int>() != controllerType) {
-            std::cerr << "wrong mapping type for this controller, cannot apply\n";
+    int simulateOffline(const OWC::CMDParser &cmd) {
+        OWC::ConfigImage img;
+
+        if (cmd.hasArg("--macro")) {
+            OWC::Macro macro;
+            std::string error;
+
+            if (!OWC::MacroCompiler::compile(std::get<std::string_view>(cmd.getValue("--macro")), 2, macro, error)) {
+                std::cerr << "--macro: " << error << "\n";
+                return 1;
+            }
+
+            img.controllerType = 2;
+            macro.fill(std::get<int>(cmd.getValue("simulate")), 2, img);
+            return simulateMacro(img, cmd);
+        }
+
+        try {
+            if (OWC::ProfileReader::read(std::string(std::get<std::string_view>(cmd.getValue("--profile"))), 0, img) != OWC::ProfileReader::Result::Ok)
+                return 1;
+
+        } catch (const YAML::Exception &yex) {
+            std::cerr << "failed to parse yaml: " << yex.msg << "\n";
             return 1;
         }
 
-        // keyboard&mouse mapping
-        for (const auto &[key, btn]: kbmKeys) {
-            if (!yaml[key])
-                continue;
+        return simulateMacro(img, cmd);
+    }
 
-            std::string kc = yaml[key].as<std::string>();
+    static void applyBackButtonKeys(const std::shared_ptr<OWC::Controller> &gpd, const OWC::Option &opt, const OWC::owc_key_list &keys) {
+        const std::shared_ptr<OWC::ControllerV2> gpdV2 = std::dynamic_pointer_cast<OWC::ControllerV2>(gpd);
+        const int maxSlots = gpdV2 ? 32 : 4;
+        bool stopCount = false;
+        int slotsC = 0;
+
+        for (int i=0,l=keys.size(); i<l && i<maxSlots; ++i) {
+            if (!stopCount) {
+                if (*keys[i] == "UNSET")
+                    stopCount = true;
+                else
+                    ++slotsC;
+            }
 
-            std::transform(kc.begin(), kc.end(), kc.begin(), ::toupper);
+            if (!gpd->setBackButton(opt.backButton, i+1, *keys[i]))
+                std::cerr << "failed to set " << opt.label << " slot " << (i + 1) << "\n";
+        }
 
-            if (!gpd->setButton(btn, kc))
-                std::cerr << "failed to set " << key << "\n";
+        if (gpdV2)
+            gpdV2->setBackButtonActiveSlots(opt.backButton, slotsC);
+    }
+
+    static void applyBackButtonTimes(const std::shared_ptr<OWC::Controller> &gpd, const OWC::Option &opt, const OWC::owc_time_list &times) {
+        const std::shared_ptr<OWC::ControllerV2> gpdV2 = std::dynamic_pointer_cast<OWC::ControllerV2>(gpd);
+        const int maxSlots = gpdV2 ? 32 : 4;
+
+        for (int i=0,l=times.size(); i<l && i<maxSlots; ++i) {
+            if (opt.target == OWC::OptionTarget::BackButtonStartTimes)
+                gpd->setBackButtonStartTime(opt.backButton, i+1, times[i]);
+            else
+                gpdV2->setBackButtonHoldTime(opt.backButton, i+1, times[i]);
         }
+    }
 
-        if (gpd->hasFeature(OWC::ControllerFeature::XinputMappingV1)) {
-            for (const auto &[key, btn]: xinptKeys) {
-                if (!yaml[key])
-                    continue;
+    static void applyBackButtonMacro(const std::shared_ptr<OWC::Controller> &gpd, const OWC::Option &opt, const std::string_view src) {
+        OWC::ConfigImage img;
+        OWC::Macro macro;
+        std::string error;
 
-                std::string kc = yaml[key].as<std::string>();
+        if (!OWC::MacroCompiler::compile(src, gpd->getControllerType(), macro, error)) {
+            std::cerr << "failed to set " << opt.label << ": " << error << "\n";
+            return;
+        }
 
-                std::transform(kc.begin(), kc.end(), kc.begin(), ::toupper);
+        if (OWC::FileLogger *logger = OWC::FileLogger::getInstance(); logger->isEnabled(OWC::LogLevel::Info)) {
+            const std::string msg = std::format("{}: {} slots, {} ms", opt.label, macro.slots.size(), macro.duration);
 
-                if (!gpd->setButton(btn, kc))
-                    std::cerr << "failed to set " << key << "\n";
-            }
+            logger->write(std::wstring(msg.begin(), msg.end()));
         }
 
-        if (controllerType == 1) {
-            importBackButtonsV1Yaml(gpd, yaml);
+        macro.fill(opt.backButton, gpd->getControllerType(), img);
+        img.apply(gpd);
+    }
 
-        } else if (controllerType == 2) {
-            const std::shared_ptr<OWC::ControllerV2> gpdV2 = std::dynamic_pointer_cast<OWC::ControllerV2>(gpd);
+    void applyConfig(const std::shared_ptr<OWC::Controller> &gpd, const OWC::CMDParser &cmd) {
+        const OWC::TraceSpan span ("applyConfig");
+        const int controllerType = gpd->getControllerType();
+
+        // options table order, l4n must come after l4 which updates the active slots count
+        for (const OWC::Option &opt: OWC::Options) {
+            if (!cmd.hasArg(opt) || (opt.controllerType != 0 && opt.controllerType != controllerType) ||
+                (opt.feature != OWC::NoFeature && !gpd->hasFeature(opt.feature)))
+                continue;
 
-            importBackButtonsV2Yaml(gpdV2, yaml);
+            const OWC::owc_arg_value &value = cmd.getValue(opt);
+
+            switch (opt.target) {
+                case OWC::OptionTarget::Button:
+                    if (!gpd->setButton(opt.button, *std::get<const std::string *>(value)))
+                        std::cerr << "failed to set " << opt.label << "\n";
+                    break;
+                case OWC::OptionTarget::BackButtonKeys:
+                    applyBackButtonKeys(gpd, opt, std::get<OWC::owc_key_list>(value));
+                    break;
+                case OWC::OptionTarget::BackButtonStartTimes:
+                case OWC::OptionTarget::BackButtonHoldTimes:
+                    applyBackButtonTimes(gpd, opt, std::get<OWC::owc_time_list>(value));
+                    break;
+                case OWC::OptionTarget::BackButtonActiveSlots:
+                    std::dynamic_pointer_cast<OWC::ControllerV2>(gpd)->setBackButtonActiveSlots(opt.backButton, std::get<int>(value));
+                    break;
+                case OWC::OptionTarget::BackButtonMacro:
+                    applyBackButtonMacro(gpd, opt, std::get<std::string_view>(value));
+                    break;
+                case OWC::OptionTarget::Rumble:
+                    gpd->setRumble(static_cast<OWC::RumbleMode>(std::get<int>(value)));
+                    break;
+                case OWC::OptionTarget::LeftCenter:
+                    gpd->setAnalogCenter(std::get<int>(value), true);
+                    break;
+                case OWC::OptionTarget::LeftBoundary:
+                    gpd->setAnalogBoundary(std::get<int>(value), true);
+                    break;
+                case OWC::OptionTarget::RightCenter:
+                    gpd->setAnalogCenter(std::get<int>(value), false);
+                    break;
+                case OWC::OptionTarget::RightBoundary:
+                    gpd->setAnalogBoundary(std::get<int>(value), false);
+                    break;
+                case OWC::OptionTarget::LedMode:
+                    gpd->setLedMode(static_cast<OWC::LedMode>(std::get<int>(value)));
+                    break;
+                case OWC::OptionTarget::LedColor: {
+                    const std::tuple<int, int, int> &color = std::get<std::tuple<int, int, int>>(value);
+
+                    gpd->setLedColor(std::get<0>(color), std::get<1>(color), std::get<2>(color));
+                }
+                    break;
+            }
         }
+    }
+
+    int writeConfig(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const OWC::CMDParser &cmd) {
+        applyConfig(gpd, cmd);
+        return commitConfig(gpd, shadow);
+    }
+
+    int readConfig(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, OWC::Diagnostics &diag) {
+        const OWC::TraceSpan span ("readConfig");
 
-        if (!gpd->writeConfig()) {
-            std::cerr << "failed to write controller\n";
+        if (!OWC::DeviceSession::getInstance()->readConfig(gpd)) {
+            diag.error("failed to read firmware config");
             return 1;
         }
 
-        std::cout << "applied config from " << fileName << "\n";
+        shadow = OWC::ConfigImage::capture(gpd);
+        OWC::ConfigCache::getInstance()->store(shadow);
         return 0;
     }
 
-    static void writeConfigBackButtonsV1(const std::shared_ptr<OWC::Controller> &gpd, const OWC::CMDParser &cmd) {
-        int num = 0;
+    // --verify retries, -1 = no read-back
+    static int verifyRetries = -1;
 
-        for (const std::string_view btn: {"l4", "r4"}) {
-            ++num;
+    void setWriteVerify(const bool enable, const int retries) {
+        verifyRetries = enable ? retries : -1;
+    }
 
-            if (!cmd.hasArg(btn.data()))
-                continue;
+    // the library can only read the whole config back, only the written blocks are compared
+    static int verifyConfig(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const int blocks, OWC::Diagnostics &diag) {
+        const OWC::TraceSpan span ("verify");
+        OWC::DeviceSession *session = OWC::DeviceSession::getInstance();
+        const OWC::ConfigImage intended = shadow;
+        std::bitset<OWC::ConfigImage::FieldCount> dropped;
+
+        for (int attempt=0; ; ++attempt) {
+            if (!session->readConfig(gpd)) {
+                diag.error("failed to read back the config");
+                return 1;
+            }
 
-            const std::vector<std::string> keys = std::get<std::vector<std::string>>(cmd.getValue(btn.data()));
+            shadow = OWC::ConfigImage::capture(gpd);
+            dropped.reset();
 
-            for (int i=0,l=keys.size(); i<l && i<4; ++i) {
-                if (!gpd->setBackButton(num, i+1, keys[i]))
-                    std::cerr << "failed to set " << btn << " slot " << (i + 1) << "\n";
+            for (int i=0; i<static_cast<int>(OWC::ConfigBlock::Count); ++i) {
+                const int block = 1 << i;
+
+                if (!(blocks & block) || intended.checksum(block, intended.present) == shadow.checksum(block, intended.present))
+                    continue;
+
+                for (int f=0; f<OWC::ConfigImage::FieldCount; ++f) {
+                    if (intended.present.test(f) && (1 << static_cast<int>(OWC::ConfigImage::fieldBlock(f))) == block && !intended.fieldEquals(shadow, f))
+                        dropped.set(f);
+                }
             }
-        }
 
-        num = 0;
-        for (const std::string_view btn: {"l4d", "r4d"}) {
-            ++num;
+            if (dropped.none())
+                return 0;
+            else if (attempt == verifyRetries)
+                break;
 
-            if (!cmd.hasArg(btn.data()))
-                continue;
+            // the firmware state is what we just read, only set what it dropped again
+            OWC::ConfigImage retry = intended;
 
-            const std::vector<int> times = std::get<std::vector<int>>(cmd.getValue(btn.data()));
+            diag.warning(std::format("firmware dropped {} {}, retrying", dropped.count(), dropped.count() == 1 ? "field" : "fields"));
+            retry.present = dropped;
+            retry.apply(gpd);
 
-            for (int i=0,l=times.size(); i<l && i<4; ++i)
-                gpd->setBackButtonStartTime(num, i+1, times[i]);
+            if (!session->writeConfig(gpd)) {
+                diag.error("failed to write controller");
+                return 1;
+            }
         }
+
+        for (int f=0; f<OWC::ConfigImage::FieldCount; ++f) {
+            if (dropped.test(f))
+                diag.error(std::format("firmware did not keep {}: wrote '{}', reads '{}'", OWC::ConfigImage::fieldName(f), intended.fieldToString(f), shadow.fieldToString(f)));
+        }
+
+        return 1;
     }
 
-    static void writeConfigBackButtonsV2(const std::shared_ptr<OWC::ControllerV2> &gpd, const OWC::CMDParser &cmd) {
-        int num = 0;
+    int commitConfig(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, OWC::Diagnostics &diag) {
+        const OWC::TraceSpan span ("commit");
+        // the library can only write the whole config, but there is no need to write it at all if nothing changed
+        const OWC::ConfigImage current = OWC::ConfigImage::capture(gpd);
+        const int dirty = current.diff(shadow);
 
-        for (const std::string_view btn: {"l4", "r4", "l5", "r5"}) {
-            ++num;
+        if (dirty == 0) {
+            diag.info("no changes to write");
+            return 0;
+        }
 
-            if (!cmd.hasArg(btn.data()))
-                continue;
+        if (OWC::FileLogger *logger = OWC::FileLogger::getInstance(); logger->isEnabled(OWC::LogLevel::Info)) {
+            std::wstring blocks = L"modified config blocks:\n";
 
-            const std::vector<std::string> keys = std::get<std::vector<std::string>>(cmd.getValue(btn.data()));
-            bool stopCount = false;
-            int slotsC = 0;
+            for (int i=0; i<static_cast<int>(OWC::ConfigBlock::Count); ++i) {
+                if (!(dirty & (1 << i)))
+                    continue;
 
-            for (int i=0,l=keys.size(); i<l && i<32; ++i) {
-                if (!stopCount) {
-                    if (keys[i] == "UNSET")
-                        stopCount = true;
-                    else
-                        ++slotsC;
-                }
+                const std::string_view block = OWC::ConfigImage::blockToString(static_cast<OWC::ConfigBlock>(i));
 
-                if (!gpd->setBackButton(num, i+1, keys[i]))
-                    std::cerr << "failed to set " << btn << " slot " << (i + 1) << "\n";
+                blocks.append(block.begin(), block.end()).append(L"\n");
             }
 
-            gpd->setBackButtonActiveSlots(num, slotsC);
+            logger->write(blocks);
         }
 
-        num = 0;
-        for (const std::string_view btn: {"l4d", "r4d", "l5d", "r5d"}) {
-            ++num;
+        OWC::ConfigCache::getInstance()->invalidate();
 
-            if (!cmd.hasArg(btn.data()))
-                continue;
+        if (const OWC::TraceSpan writeSpan ("writeConfig"); !OWC::DeviceSession::getInstance()->writeConfig(gpd)) {
+            diag.error("failed to write controller");
+            return 1;
+        }
 
-            const std::vector<int> times = std::get<std::vector<int>>(cmd.getValue(btn.data()));
+        shadow = current;
+        return verifyRetries == -1 ? 0 : verifyConfig(gpd, shadow, dirty, diag);
+    }
 
-            for (int i=0,l=times.size(); i<l && i<32; ++i)
-                gpd->setBackButtonStartTime(num, i+1, times[i]);
+    int resetConfig(const std::shared_ptr<OWC::Controller> &gpd) {
+        const OWC::TraceSpan span ("reset");
+
+        OWC::ConfigCache::getInstance()->invalidate();
+
+        if (!OWC::DeviceSession::getInstance()->resetConfig(gpd)) {
+            std::cerr << "failed to reset controller memory\n";
+            return 1;
         }
 
-        num = 0;
-        for (const std::string_view btn: {"l4h", "r4h", "l5h", "r5h"}) {
-            ++num;
+        return 0;
+    }
 
-            if (!cmd.hasArg(btn.data()))
-                continue;
+    static int runBatchCommand(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const OWC::BatchCommand &bcmd, bool &pending) {
+        const std::vector<std::string> &args = bcmd.args;
+        std::vector<const char *> argv = {nullptr};
 
-            const std::vector<int> times = std::get<std::vector<int>>(cmd.getValue(btn.data()));
+        if (args[0] != "set" && args[0] != "import" && args[0] != "export" && args[0] != "print" && args[0] != "reset" && args[0] != "commit") {
+            std::cerr << "line " << bcmd.line << ": " << args[0] << " is not allowed in batch scripts\n";
+            return 1;
+
+        } else if (args[0] == "commit") {
+            if (pending && commitConfig(gpd, shadow) != 0)
+                return 1;
 
-            for (int i=0,l=times.size(); i<l && i<32; ++i)
-                gpd->setBackButtonHoldTime(num, i+1, times[i]);
+            pending = false;
+            return 0;
         }
 
-        num = 0;
-        for (const std::string_view btn: {"l4n", "r4n", "l5n", "r5n"}) {
-            ++num;
+        for (const std::string &arg: args)
+            argv.push_back(arg.c_str());
 
-            if (!cmd.hasArg(btn.data()))
-                continue;
+        OWC::CMDParser cmd (argv.size(), argv.data());
+
+        if (!cmd.parse())
+            return 1;
+
+        if (cmd.hasArg("print")) {
+            printCurrentSettings(gpd, getPrintFilter(cmd));
+
+        } else if (cmd.hasArg("export")) {
+            return exportProfile(gpd, std::string(std::get<std::string_view>(cmd.getValue("export"))), cmd.hasArg("--fsync"));
+
+        } else if (cmd.hasArg("reset")) {
+            if (pending)
+                std::cerr << "line " << bcmd.line << ": reset discards uncommitted changes\n";
 
-            gpd->setBackButtonActiveSlots(num, std::clamp(std::get<int>(cmd.getValue(btn.data())), 0, 32));
+            pending = false;
+            if (resetConfig(gpd) != 0 || readConfig(gpd, shadow) != 0)
+                return 1;
+        } else if (cmd.hasArg("import")) {
+            try {
+                if (applyProfile(gpd, std::string(std::get<std::string_view>(cmd.getValue("import")))) != 0)
+                    return 1;
+
+            } catch (const YAML::Exception &yex) {
+                std::cerr << "failed to parse yaml: " << yex.msg << "\n";
+                return 1;
+            }
+
+            pending = true;
+
+        } else if (cmd.hasArg("set")) {
+            applyConfig(gpd, cmd);
+            pending = true;
         }
+
+        return 0;
     }
 
-    int writeConfig(const std::shared_ptr<OWC::Controller> &gpd, const OWC::CMDParser &cmd) {
-        const int controllerType = gpd->getControllerType();
+    int runBatch(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const OWC::BatchScript &script) {
+        const OWC::TraceSpan span ("batch");
+        bool pending = false;
 
-        for (const auto [karg, btn, desc]: keyArgs) {
-            if (cmd.hasArg(karg.data()) && !gpd->setButton(btn, std::get<std::string>(cmd.getValue(karg.data()))))
-                std::cerr << "failed to set " << desc << "\n";
+        for (const OWC::BatchCommand &bcmd: script.getCommands()) {
+            if (runBatchCommand(gpd, shadow, bcmd, pending) != 0) {
+                std::cerr << "batch aborted at line " << bcmd.line << (pending ? ", uncommitted changes discarded\n" : "\n");
+                return 1;
+            }
         }
 
-        if (gpd->hasFeature(OWC::ControllerFeature::XinputMappingV1)) {
-            for (const auto [karg, btn, desc]: xkeyArgs) {
-                if (cmd.hasArg(karg.data()) && !gpd->setButton(btn, std::get<std::string>(cmd.getValue(karg.data()))))
-                    std::cerr << "failed to set " << desc << "\n";
-            }
+        return pending ? commitConfig(gpd, shadow) : 0;
+    }
+
+    static void applyWatchedProfile(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const std::string &fileName) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        OWC::Diagnostics diag (true, false);
+        OWC::ConfigImage profile;
+        bool ok;
+        int count;
+
+        try {
+            ok = OWC::ProfileReader::readCopy(fileName, gpd->getControllerType(), profile, diag) == OWC::ProfileReader::Result::Ok;
+
+        } catch (const YAML::Exception &yex) {
+            diag.error(std::format("failed to parse yaml: {}", yex.msg));
+            ok = false;
         }
 
-        if (controllerType == 1)
-            writeConfigBackButtonsV1(gpd, cmd);
-        else if (controllerType == 2)
-            writeConfigBackButtonsV2(std::dynamic_pointer_cast<OWC::ControllerV2>(gpd), cmd);
+        for (const std::string &msg: diag.getErrors())
+            std::cerr << fileName << ": error: " << msg << "\n";
+
+        for (const std::string &msg: diag.getWarnings())
+            std::cerr << fileName << ": warning: " << msg << "\n";
 
-        if (gpd->hasFeature(OWC::ControllerFeature::RumbleV1) && cmd.hasArg("rmb"))
-            gpd->setRumble(static_cast<OWC::RumbleMode>(std::clamp(std::get<int>(cmd.getValue("rmb")), 0, 2)));
+        // a half valid profile is not applied, keep the last good one on the device
+        if (!ok || !diag.getErrors().empty()) {
+            std::cerr << "profile not applied\n";
+            return;
+        }
 
-        if (gpd->hasFeature(OWC::ControllerFeature::DeadZoneControlV1)) {
-            if (cmd.hasArg("lc"))
-                gpd->setAnalogCenter(std::get<int>(cmd.getValue("lc")), true);
+        profile.present = profile.changedFields(shadow);
+        count = profile.present.count();
 
-            if (cmd.hasArg("lb"))
-                gpd->setAnalogBoundary(std::get<int>(cmd.getValue("lb")), true);
+        if (count == 0) {
+            std::cout << "no changes\n";
+            return;
+        }
 
-            if (cmd.hasArg("rc"))
-                gpd->setAnalogCenter(std::get<int>(cmd.getValue("rc")), false);
+        profile.apply(gpd);
 
-            if (cmd.hasArg("rb"))
-                gpd->setAnalogBoundary(std::get<int>(cmd.getValue("rb")), false);
+        if (commitConfig(gpd, shadow) != 0) {
+            if (readConfig(gpd, shadow) != 0)
+                std::cerr << "controller config may be out of sync, restart watch\n";
+
+            return;
         }
 
-        if (gpd->hasFeature(OWC::ControllerFeature::ShoulderLedsV1)) {
-            if (cmd.hasArg("led"))
-                gpd->setLedMode(static_cast<OWC::LedMode>(std::clamp(std::get<int>(cmd.getValue("led")), 0, 3)));
+        std::cout << std::format("applied {} changed fields in {} ms\n", count,
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    }
 
-            if (cmd.hasArg("ledclr")) {
-                const std::tuple<int, int, int> color = std::get<std::tuple<int, int, int>>(cmd.getValue("ledclr"));
+    int watchProfile(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const std::string &fileName) {
+        // most editors finish a save well within this
+        constexpr int debounceMs = 30;
+        OWC::FileWatcher watcher;
 
-                gpd->setLedColor(std::get<0>(color), std::get<1>(color), std::get<2>(color));
+        if (!watcher.init(fileName))
+            return 1;
+
+        std::cout << "watching " << fileName << ", press Ctrl+C to stop\n";
+
+        applyWatchedProfile(gpd, shadow, fileName);
+        while (watcher.wait(debounceMs))
+            applyWatchedProfile(gpd, shadow, fileName);
+
+        return 0;
+    }
+
+    [[nodiscard]]
+    static bool loadSwitchProfiles(const int controllerType, const OWC::SwitchRules &rules, std::vector<OWC::ConfigImage> &images, std::vector<int> &ruleImages) {
+        std::vector<std::string> files;
+
+        // profiles shared by several rules are read once
+        auto addProfile = [&files](const std::string &file)->int {
+            const auto it = std::ranges::find(files, file);
+
+            if (it != files.end())
+                return it - files.begin();
+
+            files.push_back(file);
+            return files.size() - 1;
+        };
+
+        for (const OWC::SwitchRule &rule: rules.getRules())
+            ruleImages.push_back(addProfile(rule.profile));
+
+        if (!rules.getDefault().empty())
+            ruleImages.push_back(addProfile(rules.getDefault()));
+
+        images.resize(files.size());
+        for (int i=0,l=files.size(); i<l; ++i) {
+            try {
+                if (OWC::ProfileReader::read(files[i], controllerType, images[i]) != OWC::ProfileReader::Result::Ok) {
+                    std::cerr << "failed to load " << files[i] << "\n";
+                    return false;
+                }
+            } catch (const YAML::Exception &yex) {
+                std::cerr << "failed to parse " << files[i] << ": " << yex.msg << "\n";
+                return false;
             }
         }
 
-        if (!gpd->writeConfig()) {
-            std::cerr << "failed to write controller\n";
+        return true;
+    }
+
+    int autoSwitch(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const CommandInput &input, const int pollMs) {
+        const OWC::SwitchRules &rules = input.rules;
+        const std::vector<OWC::ConfigImage> &images = input.switchImages;
+        const std::vector<int> &ruleImages = input.ruleImages;
+        OWC::ProcessMonitor monitor (pollMs);
+        std::vector<OWC::ProcessEvent> events;
+        std::vector<std::pair<int, int>> running; // pid, rule, in start order
+        int active = -1;
+
+        if (!monitor.init())
             return 1;
+
+        std::cout << "switching profiles for " << rules.getRules().size() << " rules, press Ctrl+C to stop\n";
+
+        while (monitor.wait(events)) {
+            const OWC::ProcessEvent *trigger = nullptr;
+            std::string exe, cmdline;
+            int target;
+
+            for (const OWC::ProcessEvent &event: events) {
+                const auto it = std::ranges::find(running, event.pid, &std::pair<int, int>::first);
+                const bool tracked = it != running.end();
+                int rule = -1;
+
+                // an exec replaces the image of a tracked pid too
+                if (tracked)
+                    running.erase(it);
+
+                if (event.exec && OWC::ProcessMonitor::readProcess(event.pid, exe, cmdline))
+                    rule = rules.match(exe, cmdline);
+
+                if (rule != -1)
+                    running.emplace_back(event.pid, rule);
+
+                if (rule != -1 || tracked)
+                    trigger = &event;
+            }
+
+            // the most recently started matching process wins
+            if (!running.empty())
+                target = ruleImages[running.back().second];
+            else if (!rules.getDefault().empty())
+                target = ruleImages.back();
+            else
+                target = active;
+
+            if (target != active && target != -1) {
+                OWC::ConfigImage profile = images[target];
+                const std::string &name = running.empty() ? rules.getDefault() : rules.getRules()[running.back().second].profile;
+
+                profile.present = profile.changedFields(shadow);
+                profile.apply(gpd);
+
+                if (profile.present.any() && commitConfig(gpd, shadow) != 0) {
+                    if (readConfig(gpd, shadow) != 0)
+                        std::cerr << "controller config may be out of sync, restart autoswitch\n";
+
+                } else {
+                    active = target;
+                    // usually runs as a service with stdout to a log
+                    std::cout << std::format("switched to {} in {:.1f} ms\n", name, trigger ?
+                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - trigger->time).count() : 0.0) << std::flush;
+                }
+            }
+
+            events.clear();
         }
 
         return 0;
     }
 
-    int resetConfig(const std::shared_ptr<OWC::Controller> &gpd) {
-        if (!gpd->resetConfig()) {
-            std::cerr << "failed to reset controller memory\n";
-            return 1;
+    int loadCommandInput(const OWC::CMDParser &cmd, const int controllerType, CommandInput &input) {
+        const OWC::TraceSpan span ("loadInput");
+
+        if (cmd.hasArg("import")) {
+            const std::string fileName (std::get<std::string_view>(cmd.getValue("import")));
+
+            try {
+                if (OWC::ProfileReader::read(fileName, controllerType, input.profile) != OWC::ProfileReader::Result::Ok)
+                    return 1;
+
+            } catch (const YAML::Exception &yex) {
+                std::cerr << "failed to parse yaml: " << yex.msg << "\n";
+                return 1;
+            }
+        } else if (cmd.hasArg("export")) {
+            const std::filesystem::path dir = std::filesystem::path(std::get<std::string_view>(cmd.getValue("export"))).parent_path();
+            std::error_code ec;
+
+            if (!dir.empty() && !std::filesystem::is_directory(dir, ec)) {
+                std::cerr << "directory " << dir.string() << " does not exist\n";
+                return 1;
+            }
+        } else if (cmd.hasArg("set")) {
+            // the slot budget depends on the controller
+            for (const OWC::Option &opt: OWC::Options) {
+                OWC::Macro macro;
+                std::string error;
+
+                if (opt.type != OWC::OptionType::Macro || !cmd.hasArg(opt) || (opt.controllerType != 0 && opt.controllerType != controllerType))
+                    continue;
+
+                if (!OWC::MacroCompiler::compile(std::get<std::string_view>(cmd.getValue(opt)), controllerType, macro, error)) {
+                    std::cerr << opt.name << ": " << error << "\n";
+                    return 1;
+                }
+            }
+        } else if (cmd.hasArg("batch")) {
+            if (!input.script.load(std::string(std::get<std::string_view>(cmd.getValue("batch")))))
+                return 1;
+
+        } else if (cmd.hasArg("autoswitch")) {
+            if (!input.rules.load(std::string(std::get<std::string_view>(cmd.getValue("autoswitch")))) || !loadSwitchProfiles(controllerType, input.rules, input.switchImages, input.ruleImages))
+                return 1;
+        }
+
+        return 0;
+    }
+
+    int runCommand(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const OWC::CMDParser &cmd, const CommandInput &input) {
+        if (cmd.hasArg("print")) {
+            printCurrentSettings(gpd, getPrintFilter(cmd));
+
+        } else if (cmd.hasArg("reset")) {
+            return resetConfig(gpd);
+
+        } else if (cmd.hasArg("export")) {
+            return exportProfile(gpd, std::string(std::get<std::string_view>(cmd.getValue("export"))), cmd.hasArg("--fsync"));
+
+        } else if (cmd.hasArg("import")) {
+            return importProfile(gpd, shadow, input.profile, std::string(std::get<std::string_view>(cmd.getValue("import"))));
+
+        } else if (cmd.hasArg("set")) {
+            return writeConfig(gpd, shadow, cmd);
+
+        } else if (cmd.hasArg("simulate")) {
+            return simulateMacro(shadow, cmd);
+
+        } else if (cmd.hasArg("batch")) {
+            return runBatch(gpd, shadow, input.script);
+
+        } else if (cmd.hasArg("watch")) {
+            return watchProfile(gpd, shadow, std::string(std::get<std::string_view>(cmd.getValue("watch"))));
+
+        } else if (cmd.hasArg("autoswitch")) {
+            return autoSwitch(gpd, shadow, input, cmd.hasArg("--poll") ? std::get<int>(cmd.getValue("--poll")) : 250);
         }
 
         return 0;
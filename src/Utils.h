@@ -18,14 +18,60 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "extern/libOpenWinControls/src/controller/Controller.h"
 #include "classes/CMDParser.h"
+#include "classes/ConfigImage.h"
+#include "classes/Diagnostics.h"
+#include "classes/BatchScript.h"
+#include "classes/SwitchRules.h"
 
 namespace OWCL {
-    void printCurrentSettings(const std::shared_ptr<OWC::Controller> &gpd);
-    [[nodiscard]] int exportToYaml(const std::shared_ptr<OWC::Controller> &gpd, const std::string &fileName);
-    [[nodiscard]] int importFromYaml(const std::shared_ptr<OWC::Controller> &gpd, const std::string &fileName);
-    [[nodiscard]] int writeConfig(const std::shared_ptr<OWC::Controller> &gpd, const OWC::CMDParser &cmd);
+    struct PrintFilter final {
+        int sections = ~0; // 1 << PrintSection
+        int button = 0; // back button number, 0 = all
+        bool activeOnly = false;
+    };
+
+    struct BulkOptions final {
+        std::string format; // yaml or owcb, empty flips each file
+        std::string report; // json report file, - for stdout
+        unsigned jobs = 0; // 0 = one per core
+        bool sync = false;
+    };
+
+    // command files, read and checked before the controller is opened
+    struct CommandInput final {
+        OWC::ConfigImage profile; // import
+        OWC::BatchScript script; // batch
+        OWC::SwitchRules rules; // autoswitch
+        std::vector<OWC::ConfigImage> switchImages; // autoswitch, one per profile file
+        std::vector<int> ruleImages; // autoswitch, rule index -> image, default last
+    };
+
+    [[nodiscard]] PrintFilter getPrintFilter(const OWC::CMDParser &cmd);
+    void printCurrentSettings(const std::shared_ptr<OWC::Controller> &gpd, const PrintFilter &filter = {});
+    [[nodiscard]] int exportProfile(const std::shared_ptr<OWC::Controller> &gpd, const std::string &fileName, bool sync = false);
+    [[nodiscard]] int applyProfile(const std::shared_ptr<OWC::Controller> &gpd, const std::string &fileName);
+    [[nodiscard]] int importProfile(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const OWC::ConfigImage &profile, const std::string &fileName);
+    [[nodiscard]] int convertProfile(const std::string &inFile, const std::string &outFile, bool sync = false);
+    [[nodiscard]] BulkOptions getBulkOptions(const OWC::CMDParser &cmd);
+    [[nodiscard]] int validateProfiles(const std::vector<std::string> &paths, const BulkOptions &opts);
+    [[nodiscard]] int convertProfiles(const std::string &inDir, const std::string &outDir, const BulkOptions &opts);
+    [[nodiscard]] int simulateMacro(const OWC::ConfigImage &img, const OWC::CMDParser &cmd);
+    // simulate --profile or --macro, no device
+    [[nodiscard]] int simulateOffline(const OWC::CMDParser &cmd);
+    void applyConfig(const std::shared_ptr<OWC::Controller> &gpd, const OWC::CMDParser &cmd);
+    [[nodiscard]] int writeConfig(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const OWC::CMDParser &cmd);
+    [[nodiscard]] int readConfig(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, OWC::Diagnostics &diag = OWC::Diagnostics::console());
+    // read the written blocks back after each commit and retry what the firmware dropped
+    void setWriteVerify(bool enable, int retries);
+    [[nodiscard]] int commitConfig(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, OWC::Diagnostics &diag = OWC::Diagnostics::console());
     [[nodiscard]] int resetConfig(const std::shared_ptr<OWC::Controller> &gpd);
+    [[nodiscard]] int watchProfile(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const std::string &fileName);
+    [[nodiscard]] int autoSwitch(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const CommandInput &input, int pollMs);
+    [[nodiscard]] int runBatch(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const OWC::BatchScript &script);
+    [[nodiscard]] int loadCommandInput(const OWC::CMDParser &cmd, int controllerType, CommandInput &input);
+    [[nodiscard]] int runCommand(const std::shared_ptr<OWC::Controller> &gpd, OWC::ConfigImage &shadow, const OWC::CMDParser &cmd, const CommandInput &input);
 }
@@ -0,0 +1,287 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <format>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <new>
+
+#include "../Utils.h"
+#include "../extern/libOpenWinControls/src/include/ControllerFeature.h"
+#include "../extern/libOpenWinControls/src/include/HIDUsageIDMap.h"
+#include "../extern/libOpenWinControls/src/include/XinputUsageIDMap.h"
+#include "../extern/libOpenWinControls/src/controller/ControllerV1.h"
+#include "../extern/libOpenWinControls/src/controller/ControllerV2.h"
+
+/*
+ * owc_bench, measures the CLI paths that do not touch the device
+ *
+ * The controllers are never init()ed, they only hold config in memory, so no hardware is needed.
+ */
+
+static std::atomic<size_t> allocCount = 0;
+
+void *operator new(const size_t sz) {
+    ++allocCount;
+
+    if (void *p = std::malloc(sz ? sz : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](const size_t sz) {
+    return operator new(sz);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    std::free(p);
+}
+
+class NullBuffer final: public std::streambuf {
+protected:
+    int overflow(const int c) override { return c; }
+    std::streamsize xsputn(const char *, const std::streamsize n) override { return n; }
+};
+
+struct BenchArgs final {
+    int scale = 16;
+    int iterations = 1000;
+    unsigned seed = 1;
+};
+
+[[nodiscard]]
+static std::vector<std::string> collectKeys(const auto &usageIdMap) {
+    std::vector<std::string> keys;
+
+    for (const auto &[code, key]: usageIdMap)
+        keys.emplace_back(key);
+
+    return keys;
+}
+
+[[nodiscard]]
+static std::shared_ptr<OWC::Controller> makeFakeController(const int type) {
+    if (type == 1)
+        return std::make_shared<OWC::ControllerV1>(OWC::ControllerFeature::DeadZoneControlV1 | OWC::ControllerFeature::ShoulderLedsV1 | OWC::ControllerFeature::RumbleV1);
+
+    return std::make_shared<OWC::ControllerV2>(OWC::ControllerFeature::DeadZoneControlV1 | OWC::ControllerFeature::RumbleV1 | OWC::ControllerFeature::XinputMappingV1 |
+        OWC::ControllerFeature::BackButton3 | OWC::ControllerFeature::BackButton4);
+}
+
+[[nodiscard]]
+static OWC::ConfigImage randomProfile(const std::shared_ptr<OWC::Controller> &fake, std::mt19937 &rng, const std::vector<std::string> &keys, const std::vector<std::string> &xkeys) {
+    std::uniform_int_distribution<size_t> keyDist (0, keys.size() - 1);
+    std::uniform_int_distribution<size_t> xkeyDist (0, xkeys.size() - 1);
+    std::uniform_int_distribution<int> timeDist (0, 1000);
+    std::uniform_int_distribution<int> slotDist (0, OWC::ConfigImage::Slots);
+    std::uniform_int_distribution<int> dzDist (-10, 10);
+    OWC::ConfigImage img = OWC::ConfigImage::capture(fake);
+
+    for (std::string &key: img.kbm)
+        key = keys[keyDist(rng)];
+
+    for (std::string &key: img.xinput)
+        key = xkeys[xkeyDist(rng)];
+
+    for (int num=0; num<OWC::ConfigImage::BackButtons; ++num) {
+        for (int slot=0; slot<OWC::ConfigImage::Slots; ++slot) {
+            img.backButtonKeys[num][slot] = keys[keyDist(rng)];
+            img.backButtonStartTimes[num][slot] = timeDist(rng);
+            img.backButtonHoldTimes[num][slot] = timeDist(rng);
+        }
+
+        img.activeSlots[num] = slotDist(rng);
+    }
+
+    img.rumble = timeDist(rng) % 3;
+    img.deadZone = {dzDist(rng), dzDist(rng), dzDist(rng), dzDist(rng)};
+    img.ledMode = timeDist(rng) % 4;
+    img.ledColor = {timeDist(rng) % 256, timeDist(rng) % 256, timeDist(rng) % 256};
+
+    return img;
+}
+
+[[nodiscard]]
+static std::vector<std::string> randomSetArgs(std::mt19937 &rng, const int scale, const std::vector<std::string> &keys, const std::vector<std::string> &xkeys) {
+    static constexpr std::array<std::string_view, 21> keyOpts = {"du", "dd", "dl", "dr", "a", "b", "x", "y", "lu", "ld", "ll", "lr", "st", "sl", "mu", "l1", "l2", "l3", "r1", "r2", "r3"};
+    static constexpr std::array<std::string_view, 25> xkeyOpts = {"xdu", "xdd", "xdl", "xdr", "xa", "xb", "xx", "xy", "xlu", "xld", "xll", "xlr", "xru", "xrd", "xrl", "xrr",
+        "xst", "xsl", "xmu", "xl1", "xl2", "xl3", "xr1", "xr2", "xr3"};
+    std::uniform_int_distribution<size_t> keyDist (0, keys.size() - 1);
+    std::uniform_int_distribution<size_t> xkeyDist (0, xkeys.size() - 1);
+    std::uniform_int_distribution<int> timeDist (0, 1000);
+    std::vector<std::string> args = {"bench", "set"};
+
+    for (int s=0; s<scale; ++s) {
+        for (const std::string_view opt: keyOpts)
+            args.insert(args.end(), {std::string(opt), keys[keyDist(rng)]});
+
+        for (const std::string_view opt: xkeyOpts)
+            args.insert(args.end(), {std::string(opt), xkeys[xkeyDist(rng)]});
+
+        for (const std::string_view btn: {"l4", "r4", "l5", "r5"}) {
+            std::string list, startList, holdList;
+
+            for (int i=0; i<OWC::ConfigImage::Slots; ++i) {
+                list.append(i ? "," : "").append(keys[keyDist(rng)]);
+                startList.append(i ? "," : "").append(std::to_string(timeDist(rng)));
+                holdList.append(i ? "," : "").append(std::to_string(timeDist(rng)));
+            }
+
+            args.insert(args.end(), {std::string(btn), list, std::format("{}d", btn), startList, std::format("{}h", btn), holdList});
+        }
+
+        args.insert(args.end(), {"rmb", "1", "lc", "-3", "rb", "4", "led", "2", "ledclr", "10:20:30"});
+    }
+
+    return args;
+}
+
+static void report(const std::string_view name, const int iterations, const std::function<void(int)> &op) {
+    NullBuffer nullBuf;
+    std::streambuf *coutBuf = std::cout.rdbuf(&nullBuf);
+    const size_t allocStart = allocCount;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i=0; i<iterations; ++i)
+        op(i);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    const double allocs = static_cast<double>(allocCount - allocStart) / iterations;
+
+    std::cout.rdbuf(coutBuf);
+    std::cout << std::format("{:<28}{:>14.1f} ns/op{:>12.1f} allocs/op\n", name, static_cast<double>(elapsed) / iterations, allocs);
+}
+
+static void benchParse(const BenchArgs &bargs, std::mt19937 &rng, const std::vector<std::string> &keys, const std::vector<std::string> &xkeys) {
+    const std::vector<std::string> base = randomSetArgs(rng, bargs.scale, keys, xkeys);
+    std::vector<const char *> argv;
+
+    // parse() only reads argv, every iteration shares it
+    for (const std::string &arg: base)
+        argv.push_back(arg.c_str());
+
+    report(std::format("parse set ({} args)", base.size()), bargs.iterations, [&argv](const int) {
+        OWC::CMDParser cmd (argv.size(), argv.data());
+
+        if (!cmd.parse())
+            std::cerr << "parse failed\n";
+    });
+}
+
+static void benchController(const int type, const BenchArgs &bargs, std::mt19937 &rng, const std::vector<std::string> &keys, const std::vector<std::string> &xkeys) {
+    const std::filesystem::path tmpDir = std::filesystem::temp_directory_path();
+    std::vector<std::shared_ptr<OWC::Controller>> fakes;
+    std::vector<std::string> profileFiles;
+    NullBuffer nullBuf;
+    std::streambuf *coutBuf = std::cout.rdbuf(&nullBuf);
+
+    // one fake controller per random profile, so that the timed loops do not include applying it
+    for (int i=0; i<bargs.scale; ++i) {
+        fakes.push_back(makeFakeController(type));
+        randomProfile(fakes.back(), rng, keys, xkeys).apply(fakes.back());
+        profileFiles.push_back((tmpDir / std::format("owc_bench_v{}_{}.yaml", type, i)).string());
+
+        if (OWCL::exportProfile(fakes.back(), profileFiles.back()) != 0) {
+            std::cout.rdbuf(coutBuf);
+            return;
+        }
+    }
+
+    std::cout.rdbuf(coutBuf);
+
+    // stdout goes to the null sink while timing
+    report(std::format("V{} export", type), bargs.iterations, [&](const int i) {
+        if (OWCL::exportProfile(fakes[i % bargs.scale], "-") != 0)
+            std::cerr << "export failed\n";
+    });
+
+    report(std::format("V{} import", type), bargs.iterations, [&](const int i) {
+        if (OWCL::applyProfile(fakes[0], profileFiles[i % bargs.scale]) != 0)
+            std::cerr << "import failed\n";
+    });
+
+    report(std::format("V{} print", type), bargs.iterations, [&](const int i) {
+        OWCL::printCurrentSettings(fakes[i % bargs.scale]);
+    });
+
+    for (const std::string &file: profileFiles)
+        std::filesystem::remove(file);
+}
+
+[[nodiscard]]
+static bool parseBenchArgs(const int argc, char *argv[], BenchArgs &bargs) {
+    for (int i=1; i<argc; i+=2) {
+        const std::string_view arg = argv[i];
+
+        if (i + 1 >= argc || (arg != "--scale" && arg != "--iterations" && arg != "--seed")) {
+            std::cerr << "usage: owc_bench [--scale profiles] [--iterations n] [--seed n]\n";
+            return false;
+        }
+
+        const int val = std::atoi(argv[i + 1]);
+
+        if (val < 1) {
+            std::cerr << arg << " must be > 0\n";
+            return false;
+        }
+
+        if (arg == "--scale")
+            bargs.scale = val;
+        else if (arg == "--iterations")
+            bargs.iterations = val;
+        else
+            bargs.seed = val;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    const std::vector<std::string> keys = collectKeys(OWC::HIDUsageIDMap);
+    const std::vector<std::string> xkeys = collectKeys(OWC::XinputUsageIDMap);
+    BenchArgs bargs;
+
+    if (!parseBenchArgs(argc, argv, bargs))
+        return 1;
+
+    std::mt19937 rng (bargs.seed);
+
+    std::cout << std::format("scale {}, {} iterations, seed {}\n\n", bargs.scale, bargs.iterations, bargs.seed);
+    benchParse(bargs, rng, keys, xkeys);
+    benchController(1, bargs, rng, keys, xkeys);
+    benchController(2, bargs, rng, keys, xkeys);
+
+    return 0;
+}
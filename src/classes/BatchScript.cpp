@@ -0,0 +1,90 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <cctype>
+
+#include "BatchScript.h"
+
+namespace OWC {
+    bool BatchScript::tokenize(const std::string_view line, const int lineNum) {
+        std::vector<std::string> args;
+        size_t i = 0;
+
+        while (i < line.size()) {
+            std::string token;
+
+            if (std::isspace(static_cast<unsigned char>(line[i]))) {
+                ++i;
+                continue;
+
+            } else if (line[i] == '#') {
+                break;
+            }
+
+            while (i < line.size() && !std::isspace(static_cast<unsigned char>(line[i]))) {
+                if (line[i] == '"' || line[i] == '\'') {
+                    const size_t end = line.find(line[i], i + 1);
+
+                    if (end == std::string_view::npos) {
+                        std::cerr << "line " << lineNum << ": unterminated quote\n";
+                        return false;
+                    }
+
+                    token.append(line.substr(i + 1, end - i - 1));
+                    i = end + 1;
+
+                } else {
+                    token.push_back(line[i++]);
+                }
+            }
+
+            args.emplace_back(std::move(token));
+        }
+
+        if (!args.empty())
+            commands.emplace_back(lineNum, std::move(args));
+
+        return true;
+    }
+
+    bool BatchScript::load(const std::string &fileName) {
+        std::ifstream file;
+        std::istream *in = &std::cin;
+        std::string line;
+        int lineNum = 0;
+
+        if (fileName != "-") {
+            file.open(fileName);
+
+            if (!file.is_open()) {
+                std::cerr << "failed to open " << fileName << "\n";
+                return false;
+            }
+
+            in = &file;
+        }
+
+        while (std::getline(*in, line)) {
+            if (!tokenize(line, ++lineNum))
+                return false;
+        }
+
+        return true;
+    }
+}
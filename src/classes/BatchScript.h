@@ -0,0 +1,40 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace OWC {
+    struct BatchCommand final {
+        int line;
+        std::vector<std::string> args;
+    };
+
+    class BatchScript final {
+    private:
+        std::vector<BatchCommand> commands;
+
+        [[nodiscard]] bool tokenize(std::string_view line, int lineNum);
+
+    public:
+        [[nodiscard]] bool load(const std::string &fileName);
+        [[nodiscard]] const std::vector<BatchCommand> &getCommands() const { return commands; }
+    };
+}
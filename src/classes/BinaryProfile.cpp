@@ -0,0 +1,211 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <format>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#include "BinaryProfile.h"
+#include "KeyTable.h"
+
+namespace OWC {
+    static constexpr std::array<uint32_t, 256> crcTable = [] {
+        std::array<uint32_t, 256> table {};
+
+        for (uint32_t i=0; i<256; ++i) {
+            uint32_t c = i;
+
+            for (int k=0; k<8; ++k)
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+
+            table[i] = c;
+        }
+
+        return table;
+    }();
+
+    [[nodiscard]]
+    static uint32_t crc32(const void *data, const size_t len) {
+        const uint8_t *p = static_cast<const uint8_t *>(data);
+        uint32_t crc = 0xffffffffu;
+
+        for (size_t i=0; i<len; ++i)
+            crc = crcTable[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+
+        return crc ^ 0xffffffffu;
+    }
+
+    // the layout is little endian, a no-op on the hosts we ship for
+    template<typename T>
+    [[nodiscard]]
+    static T toLE(T val) {
+        if constexpr (std::endian::native == std::endian::big) {
+            T ret;
+
+            for (size_t i=0; i<sizeof(T); ++i)
+                reinterpret_cast<uint8_t *>(&ret)[i] = reinterpret_cast<const uint8_t *>(&val)[sizeof(T) - 1 - i];
+
+            return ret;
+        }
+
+        return val;
+    }
+
+    [[nodiscard]]
+    static bool keyToUsage(const KeyTable &table, const std::string &name, uint16_t &usage, Diagnostics &diag) {
+        const int code = table.find(name);
+
+        if (code < 0 || code > 0xffff) {
+            diag.error(std::format("cannot store key {} in binary profile", name));
+            return false;
+        }
+
+        usage = toLE(static_cast<uint16_t>(code));
+        return true;
+    }
+
+    [[nodiscard]]
+    static bool usageToKey(const KeyTable &table, const uint16_t usage, std::string &name, Diagnostics &diag) {
+        const std::string_view key = table.nameOf(toLE(usage));
+
+        if (key.empty()) {
+            diag.error(std::format("invalid key usage id {} in binary profile", toLE(usage)));
+            return false;
+        }
+
+        name.assign(key);
+        return true;
+    }
+
+    bool BinaryProfile::isBinary(const std::string_view data) {
+        return data.starts_with(Magic);
+    }
+
+    bool BinaryProfile::encode(const ConfigImage &img, std::string &out, Diagnostics &diag) {
+        Header header {};
+        Payload payload {};
+
+        for (int i=0; i<ProfileFields; ++i) {
+            if (!img.present.test(i))
+                continue;
+
+            payload.present[i / 8] |= 1 << (i % 8);
+            header.blocks |= 1 << static_cast<int>(ConfigImage::fieldBlock(i));
+        }
+
+        for (int i=0; i<ConfigImage::KbmFields; ++i) {
+            if (img.present.test(ConfigImage::fieldKbm(i)) && !keyToUsage(KeyTable::getHID(), img.kbm[i], payload.kbm[i], diag))
+                return false;
+        }
+
+        for (int i=0; i<ConfigImage::XinputFields; ++i) {
+            if (img.present.test(ConfigImage::fieldXinput(i)) && !keyToUsage(KeyTable::getXinput(), img.xinput[i], payload.xinput[i], diag))
+                return false;
+        }
+
+        for (int num=1; num<=ConfigImage::BackButtons; ++num) {
+            BackButton &bb = payload.backButtons[num - 1];
+
+            for (int slot=1; slot<=ConfigImage::Slots; ++slot) {
+                Slot &sl = bb.slots[slot - 1];
+
+                if (img.present.test(ConfigImage::fieldBackButton(num, slot, ConfigImage::SlotField::Key)) && !keyToUsage(KeyTable::getHID(), img.backButtonKeys[num - 1][slot - 1], sl.key, diag))
+                    return false;
+
+                sl.startTime = toLE<int32_t>(img.backButtonStartTimes[num - 1][slot - 1]);
+                sl.holdTime = toLE<int32_t>(img.backButtonHoldTimes[num - 1][slot - 1]);
+            }
+
+            bb.activeSlots = img.activeSlots[num - 1];
+        }
+
+        std::memcpy(header.magic, Magic.data(), sizeof(header.magic));
+        header.version = toLE(Version);
+        header.mappingType = toLE(static_cast<uint16_t>(img.controllerType));
+        header.blocks = toLE(header.blocks);
+        header.payloadSize = toLE<uint32_t>(sizeof(payload));
+        header.checksum = toLE(crc32(&payload, sizeof(payload)));
+
+        out.assign(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.append(reinterpret_cast<const char *>(&payload), sizeof(payload));
+        return true;
+    }
+
+    bool BinaryProfile::decode(const std::string_view data, ConfigImage &img, Diagnostics &diag) {
+        ConfigImage tmp;
+        Header header;
+        Payload payload;
+
+        if (data.size() < sizeof(header) || !isBinary(data)) {
+            diag.error("invalid binary profile");
+            return false;
+        }
+
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        if (toLE(header.version) != Version) {
+            diag.error(std::format("unsupported binary profile version {}", toLE(header.version)));
+            return false;
+
+        } else if (toLE(header.payloadSize) != sizeof(payload) || data.size() != sizeof(header) + sizeof(payload)) {
+            diag.error("binary profile is truncated or corrupted");
+            return false;
+        }
+
+        std::memcpy(&payload, data.data() + sizeof(header), sizeof(payload));
+
+        if (toLE(header.checksum) != crc32(&payload, sizeof(payload))) {
+            diag.error("binary profile checksum mismatch");
+            return false;
+        }
+
+        for (int i=0; i<ProfileFields; ++i)
+            tmp.present.set(i, (payload.present[i / 8] >> (i % 8)) & 1);
+
+        for (int i=0; i<ConfigImage::KbmFields; ++i) {
+            if (tmp.present.test(ConfigImage::fieldKbm(i)) && !usageToKey(KeyTable::getHID(), payload.kbm[i], tmp.kbm[i], diag))
+                return false;
+        }
+
+        for (int i=0; i<ConfigImage::XinputFields; ++i) {
+            if (tmp.present.test(ConfigImage::fieldXinput(i)) && !usageToKey(KeyTable::getXinput(), payload.xinput[i], tmp.xinput[i], diag))
+                return false;
+        }
+
+        for (int num=1; num<=ConfigImage::BackButtons; ++num) {
+            const BackButton &bb = payload.backButtons[num - 1];
+
+            for (int slot=1; slot<=ConfigImage::Slots; ++slot) {
+                const Slot &sl = bb.slots[slot - 1];
+
+                if (tmp.present.test(ConfigImage::fieldBackButton(num, slot, ConfigImage::SlotField::Key)) && !usageToKey(KeyTable::getHID(), sl.key, tmp.backButtonKeys[num - 1][slot - 1], diag))
+                    return false;
+
+                tmp.backButtonStartTimes[num - 1][slot - 1] = toLE(sl.startTime);
+                tmp.backButtonHoldTimes[num - 1][slot - 1] = toLE(sl.holdTime);
+            }
+
+            tmp.activeSlots[num - 1] = std::min<int>(bb.activeSlots, ConfigImage::Slots);
+        }
+
+        tmp.controllerType = toLE(header.mappingType);
+        img = std::move(tmp);
+        return true;
+    }
+}
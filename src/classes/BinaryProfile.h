@@ -0,0 +1,80 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "ConfigImage.h"
+#include "Diagnostics.h"
+
+namespace OWC {
+    /*
+     * .owcb profile, a fixed little endian layout holding the same fields as a yaml profile
+     *
+     * Header, then Payload. Keys are stored as usage IDs, the checksum is a CRC-32 of the payload.
+     * Fields missing from the profile have their presence bit cleared and are left untouched on import.
+     */
+    class BinaryProfile final {
+    public:
+        static constexpr std::string_view Magic = "OWCB";
+        static constexpr uint16_t Version = 1;
+        // mapping and back button fields, the leading part of the config image field index
+        static constexpr int ProfileFields = ConfigImage::fieldRumble();
+
+        struct Header final {
+            char magic[4];
+            uint16_t version;
+            uint16_t mappingType;
+            uint32_t blocks; // 1 << ConfigBlock for each block with at least one field
+            uint32_t payloadSize;
+            uint32_t checksum;
+            uint8_t reserved[12];
+        };
+
+        struct Slot final {
+            uint16_t key;
+            uint16_t reserved;
+            int32_t startTime;
+            int32_t holdTime;
+        };
+
+        struct BackButton final {
+            Slot slots[ConfigImage::Slots];
+            uint8_t activeSlots;
+            uint8_t reserved[3];
+        };
+
+        struct Payload final {
+            uint8_t present[(ProfileFields + 31) / 32 * 4];
+            uint16_t kbm[ConfigImage::KbmFields];
+            uint16_t xinput[ConfigImage::XinputFields];
+            BackButton backButtons[ConfigImage::BackButtons];
+        };
+
+        BinaryProfile() = delete;
+
+        [[nodiscard]] static bool isBinary(std::string_view data);
+        [[nodiscard]] static bool encode(const ConfigImage &img, std::string &out, Diagnostics &diag = Diagnostics::console());
+        [[nodiscard]] static bool decode(std::string_view data, ConfigImage &img, Diagnostics &diag = Diagnostics::console());
+    };
+
+    static_assert(sizeof(BinaryProfile::Header) == 32);
+    static_assert(sizeof(BinaryProfile::Payload) == 1700);
+}
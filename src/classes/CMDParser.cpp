@@ -18,22 +18,28 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
-#include <cstring>
+#include <charconv>
+#include <cctype>
 
 #include "CMDParser.h"
 #include "../version.h"
+#include "KeyTable.h"
+#include "MacroCompiler.h"
 #include "../extern/libOpenWinControls/src/include/HIDUsageIDMap.h"
 #include "../extern/libOpenWinControls/src/include/XinputUsageIDMap.h"
 
 namespace OWC {
-    CMDParser::CMDParser(const int argc, char *argv[]) {
+    CMDParser::CMDParser(const int argc, const char *const argv[]) {
         argC = argc - 1;
         argV = argv + 1;
+
+        // one value per arg at most
+        values.reserve(std::max(argC, 0));
     }
 
     void CMDParser::showHelp() const {
         std::cout << APP_NAME << " " << APP_VER_MAJOR << "." << APP_VER_MINOR << "\n\n"
-            "Usage: " << APP_NAME << " command [args]\n\n"
+            "Usage: " << APP_NAME << " [global options] command [args]\n\n"
 
             "Some options only apply to V1 or V2, incompatible options, if provided, are ignored.\n\n"
 
@@ -47,167 +53,86 @@ namespace OWC {
             "  set option value [..]\n"
             "    set firmware settings\n"
             "    Example: set du w dl space [..]\n\n"
-            "  export file_name.yaml\n"
-            "    export current firmware mapping to a yaml file to share with others or apply back later\n\n"
+            "  export file_name.yaml [--fsync]\n"
+            "    export current firmware mapping to a yaml file to share with others or apply back later\n"
+            "    Use a .owcb extension for a compact binary profile, or - to write yaml to stdout\n"
+            "    The file is replaced atomically, --fsync also flushes it to disk before returning\n"
+            "    Served from the config cache, see --no-cache\n\n"
             "  import file_name.yaml\n"
-            "    apply mapping from file\n\n"
-            "  print\n"
-            "    Print current firmware settings\n\n"
+            "    apply mapping from file, yaml or binary (.owcb)\n\n"
+            "  convert in_file out_file [--fsync]\n"
+            "    convert a profile between yaml and binary, the output format is chosen by extension (.owcb for binary)\n\n"
+            "  convert in_dir out_dir [--to yaml|owcb] [--jobs N] [--report file.json] [--fsync]\n"
+            "    convert every profile in a directory tree, keeping the layout, the default flips each file format\n\n"
+            "  validate path [path..] [--jobs N] [--report file.json]\n"
+            "    check profiles without a device: mapping type, key names, slot counts and times\n"
+            "    Directories are searched for .yaml, .yml and .owcb files, files are checked in parallel\n"
+            "    --report: write a JSON report, - for stdout. Exits with 1 if any profile has errors\n\n"
+            "  print [--section name[,name..]] [--button name] [--active-only]\n"
+            "    Print current firmware settings\n"
+            "    --section: only print info, kbm, xinput, back, rumble, deadzone or leds\n"
+            "    --button: only print back button L4, R4, L5 or R5\n"
+            "    --active-only: only print V2 back button slots up to the active slots count\n"
+            "    V1 settings are served from the config cache, see --no-cache\n\n"
+            "  simulate button [--profile file | --macro steps] [--json]\n"
+            "    Expand a V2 back button macro (L4, R4, L5 or R5) into its press and release timeline\n"
+            "    Reports the duration, overlapping holds of a key, zero-length presses, negative times, slots past the active count\n"
+            "    and more than 6 keys down at once. Slots come from the controller, a profile or a macro (see l4m), no device is needed for the last two\n"
+            "    --json: print the timeline as JSON instead of text\n\n"
             "  reset\n"
             "    Reset controller memory to a known working state\n\n"
-
-            "Options:\n\n"
-            "  du [key]\n"
-            "    Assign dpad up a key\n\n"
-            "  dd [key]\n"
-            "    Assign dpad down a key\n\n"
-            "  dl [key]\n"
-            "    Assign dpad left a key\n\n"
-            "  dr [key]\n"
-            "    Assign dpad right a key\n\n"
-            "  a [key]\n"
-            "    Assign A button a key\n\n"
-            "  b [key]\n"
-            "    Assign B button a key\n\n"
-            "  x [key]\n"
-            "    Assign X button a key\n\n"
-            "  y [key]\n"
-            "    Assign Y button a key\n\n"
-            "  lu [key]\n"
-            "    Assign left analog up a key\n\n"
-            "  ld [key]\n"
-            "    Assign left analog down a key\n\n"
-            "  ll [key]\n"
-            "    Assign left analog left a key\n\n"
-            "  lr [key]\n"
-            "    Assign left analog right a key\n\n"
-            "  st [key]\n"
-            "    Assign start button a key\n\n"
-            "  sl [key]\n"
-            "    Assign select button a key\n\n"
-            "  mu [key]\n"
-            "    Assign menu button a key\n\n"
-            "  l1 [key]\n"
-            "    Assign L1 button a key\n\n"
-            "  l2 [key]\n"
-            "    Assign L2 button a key\n\n"
-            "  l3 [key]\n"
-            "    Assign L3 button a key\n\n"
-            "  r1 [key]\n"
-            "    Assign R1 button a key\n\n"
-            "  r2 [key]\n"
-            "    Assign R2 button a key\n\n"
-            "  r3 [key]\n"
-            "    Assign R3 button a key\n\n"
-            "  xdu [xinput button]\n"
-            "    Reassign dpad up button\n\n"
-            "  xdd [xinput button]\n"
-            "    Reassign dpad down button\n\n"
-            "  xdl [xinput button]\n"
-            "    Reassign dpad left button\n\n"
-            "  xdr [xinput button]\n"
-            "    Reassign dpad right button\n\n"
-            "  xa [xinput button]\n"
-            "    Reassign A button button\n\n"
-            "  xb [xinput button]\n"
-            "    Reassign B button button\n\n"
-            "  xx [xinput button]\n"
-            "    Reassign X button button\n\n"
-            "  xy [xinput button]\n"
-            "    Reassign Y button button\n\n"
-            "  xlu [xinput button]\n"
-            "    Reassign left analog up button\n\n"
-            "  xld [xinput button]\n"
-            "    Reassign left analog down button\n\n"
-            "  xll [xinput button]\n"
-            "    Reassign left analog left button\n\n"
-            "  xlr [xinput button]\n"
-            "    Reassign left analog right button\n\n"
-            "  xru [xinput button]\n"
-            "    Reassign right analog up button\n\n"
-            "  xrd [xinput button]\n"
-            "    Reassign right analog down button\n\n"
-            "  xrl [xinput button]\n"
-            "    Reassign right analog left button\n\n"
-            "  xrr [xinput button]\n"
-            "    Reassign right analog right button\n\n"
-            "  xst [xinput button]\n"
-            "    Reassign start button button\n\n"
-            "  xsl [xinput button]\n"
-            "    Reassign select button button\n\n"
-            "  xmu [xinput button]\n"
-            "    Reassign menu button button\n\n"
-            "  xl1 [xinput button]\n"
-            "    Reassign L1 button button\n\n"
-            "  xl2 [xinput button]\n"
-            "    Reassign L2 button button\n\n"
-            "  xl3 [xinput button]\n"
-            "    Reassign L3 button button\n\n"
-            "  xr1 [xinput button]\n"
-            "    Reassign R1 button button\n\n"
-            "  xr2 [xinput button]\n"
-            "    Reassign R2 button button\n\n"
-            "  xr3 [xinput button]\n"
-            "    Reassign R3 button button\n\n"
-            "  l4 [key1,key2,key3..]\n"
-            "    Comma separated list of keys\n"
-            "    Assign L4 back button\n\n"
-            "  l4d [time1,time2..]\n"
-            "    Comma separated list of times\n"
-            "    Set L4 back button keys start time in milliseconds\n\n"
-            "  l4h [time1,time2..]\n"
-            "    Comma separated list of times\n"
-            "    Set L4 back button keys hold time in milliseconds\n\n"
-            "  l4n [num]\n"
-            "    Manually override L4 macro active slots number [0, 32]\n\n"
-            "  r4 [key1,key2,key3..]\n"
-            "    Comma separated list of keys\n"
-            "    Assign R4 back button\n\n"
-            "  r4d [time1,time2..]\n"
-            "    Comma separated list of times\n"
-            "    Set R4 back button keys start time in milliseconds\n\n"
-            "  r4h [time1,time2..]\n"
-            "    Comma separated list of times\n"
-            "    Set R4 back button keys hold time in milliseconds\n\n"
-            "  r4n [num]\n"
-            "    Manually override R4 macro active slots number [0, 32]\n\n"
-            "  l5 [key1,key2,key3..]\n"
-            "    Comma separated list of keys\n"
-            "    Assign L5 back button\n\n"
-            "  l5d [time1,time2..]\n"
-            "    Comma separated list of times\n"
-            "    Set L5 back button keys start time in milliseconds\n\n"
-            "  l5h [time1,time2..]\n"
-            "    Comma separated list of times\n"
-            "    Set L5 back button keys hold time in milliseconds\n\n"
-            "  l5n [num]\n"
-            "    Manually override L5 macro active slots number [0, 32]\n\n"
-            "  r5 [key1,key2,key3..]\n"
-            "    Comma separated list of keys\n"
-            "    Assign R5 back button\n\n"
-            "  r5d [time1,time2..]\n"
-            "    Comma separated list of times\n"
-            "    Set R5 back button keys start time in milliseconds\n\n"
-            "  r5h [time1,time2..]\n"
-            "    Comma separated list of times\n"
-            "    Set R5 back button keys hold time in milliseconds\n\n"
-            "  r5n [num]\n"
-            "    Manually override R5 macro active slots number [0, 32]\n\n"
-            "  rmb [mode]\n"
-            "    Set vibration intensity [0 = off, 1 = low, 2 = high]\n\n"
-            "  lc [value]\n"
-            "    Adjust left analog deadzone [-10, +10]\n\n"
-            "  lb [value]\n"
-            "    Adjust left analog boundary [-10, +10]\n\n"
-            "  rc [value]\n"
-            "    Adjust right analog deadzone [-10, +10]\n\n"
-            "  rb [value]\n"
-            "    Adjust right analog boundary [-10, +10]\n\n"
-            "  led [mode]\n"
-            "    Set shoulder buttons led mode [0 = off, 1 = solid, 2 = breathe, 3 = rotate]\n\n"
-            "  ledclr [R:G:B]\n"
-            "    Set shoulder buttons led color [0-255:0-255:0-255]\n\n"
-
+            "  batch script_file\n"
+            "    Run one command per line (set, import, export, print, reset, commit) in a single device session\n"
+            "    Changes are written once at the end or at each commit line, use - to read the script from stdin\n"
+            "    Example script:\n"
+            "      reset\n"
+            "      import base.yaml\n"
+            "      set l4 F13\n"
+            "      export after.yaml\n\n"
+            "  watch file_name.yaml\n"
+            "    apply a profile, then apply it again on every save until Ctrl+C\n"
+            "    Only the fields changed since the last apply are set, profiles with errors are not applied\n\n"
+            "  autoswitch rules_file [--poll ms]\n"
+            "    apply a profile when a matching program starts, profiles are loaded once at startup\n"
+            "    Rules, one per line, the most recently started match wins:\n"
+            "      exe eldenring.exe -> elden.yaml\n"
+            "      cmdline \\bhl2\\.exe\\b -> hl2.owcb\n"
+            "      default -> base.yaml\n"
+            "    Use cmdline for Wine/Proton games, their executable is the wine loader\n"
+            "    Process events come from the proc connector (root), else /proc is polled every --poll ms (250)\n\n"
+            "  devices\n"
+            "    list attached controllers: hidraw nodes, vendor:product id, serial and usb port\n\n"
+            "  daemon\n"
+            "    Keep the controller open and serve commands from other instances (owcd)\n"
+            "    While running, commands are forwarded to it instead of opening the device\n"
+            "    Socket path: $OWCD_SOCKET, $XDG_RUNTIME_DIR/owcd.sock or /tmp/owcd-[uid].sock\n\n"
+
+            "Global options, before the command:\n\n"
+            "  --no-cache\n"
+            "    Always read the config from the device instead of the config cache\n"
+            "    print (V1 only) and export are served from the cache when board, firmware and boot are unchanged\n"
+            "    Linux only, other platforms have no boot id to expire it and always read the device\n"
+            "    Changes made since then by another tool (GPD WinControls, another cache dir) are not seen, use --no-cache after them\n\n"
+            "  --trace file.json\n"
+            "    Write a Chrome/Perfetto trace of the command stages (chrome://tracing, ui.perfetto.dev)\n\n"
+            "  --timings\n"
+            "    Print a per-stage time summary to stderr\n\n"
+            "  --verify [--retry N]\n"
+            "    Read the config back after each write and report the fields the firmware did not keep\n"
+            "    Only the written blocks are compared, --retry writes the dropped fields again up to N times\n\n"
+            "  --record file.owctrace\n"
+            "    Record every controller call (init, readVersion, readConfig, writeConfig, resetConfig) with its result and timing\n\n"
+            "  --replay file.owctrace [--replay-speed fast|real]\n"
+            "    Run the command against a recording instead of the controller, no device needed\n"
+            "    fast (default) answers at once, real keeps the recorded timing of each call and the gaps between them\n"
+            "    Both options skip the config cache and are never forwarded to the daemon\n\n"
+
+            "Options:\n\n";
+
+        for (const Option &opt: Options)
+            std::cout << "  " << opt.name << " " << opt.argHelp << "\n    " << opt.help << "\n\n";
+
+        std::cout <<
             "Notes:\n\n"
             "  Controller V1 features:\n"
             "     Supports up to 4 key/time slots for back buttons macro.\n"
@@ -223,7 +148,16 @@ namespace OWC {
             "     Center refers to the deadzone itself, 0 is the default value from GPD, roughtly ~15%.\n"
             "     A value of -10 removes the deadzone.\n"
             "     Boundary refers to the circularity, 0 is the default value from GPD, roughtly ~13% average error.\n"
-            "     A value of -10 should lessen the average error on circularity tests.\n\n";
+            "     A value of -10 should lessen the average error on circularity tests.\n\n"
+            "  Back button macros (l4m, r4m, l5m, r5m, L4_MACRO: in profiles):\n"
+            "     Steps separated by ';' run in order, e.g. \"ctrl+shift+esc; wait 40; f13*3 @20ms\".\n"
+            "     a+b is a chord sharing one start time, *n repeats a step, @n holds it n ms (V2, default 50), wait n pauses.\n"
+            "     A step starts when the previous one is released, a repeated key is released 10 ms before its next press.\n"
+            "     V2 keeps a modifier held by consecutive steps in one slot, up to 32 slots.\n"
+            "     V1 has 3 timed slots, a leading wait becomes the macro start time.\n\n"
+            "  Logging:\n"
+            "     OWC_LOG_FILE sets the log file path, OWC_LOG_LEVEL one of off, error, warning, info, debug (default).\n"
+            "     The log is rotated to <file>.1 once it grows past 1 MB.\n\n";
     }
 
     void CMDParser::showKeys() const {
@@ -242,10 +176,110 @@ namespace OWC {
             std::cout << "  " << key << "\n";
     }
 
+    // calls fn on every non empty item of a comma separated list, stops at the first false
+    template<typename Fn>
+    [[nodiscard]]
+    static bool forEachItem(const std::string_view list, Fn &&fn) {
+        for (size_t start = 0, end; start < list.size(); start = end + 1) {
+            end = std::min(list.find(',', start), list.size());
+
+            if (end > start && !fn(list.substr(start, end - start)))
+                return false;
+        }
+
+        return true;
+    }
+
+    // back button number, case insensitive, 0 if unknown
+    [[nodiscard]]
+    static int findBackButton(const std::string_view name) {
+        const auto it = std::ranges::find_if(BackButtonNames, [name](const std::string_view btn)->bool {
+            return std::ranges::equal(btn, name, [](const char a, const unsigned char b)->bool { return a == std::toupper(b); });
+        });
+
+        return it == BackButtonNames.end() ? 0 : it - BackButtonNames.begin() + 1;
+    }
+
+    int CMDParser::argId(const std::string_view arg) {
+        if (const Option *opt = findOption(arg))
+            return opt - Options.data();
+
+        const auto it = std::ranges::find(ArgNames, arg);
+
+        return it == ArgNames.end() ? -1 : static_cast<int>(Options.size() + (it - ArgNames.begin()));
+    }
+
+    bool CMDParser::parseInt(const std::string_view str, int &out) {
+        const char *end = str.data() + str.size();
+        const auto [ptr, ec] = std::from_chars(str.data(), end, out);
+
+        return ec == std::errc() && ptr == end;
+    }
+
+    bool CMDParser::hasArg(const std::string_view arg) const {
+        const int id = argId(arg);
+
+        return id != -1 && slots[id] != 0;
+    }
+
     bool CMDParser::isArg(const std::string_view arg) const {
         return arg == argV[0];
     }
 
+    void CMDParser::store(const int id, owc_arg_value &&value, const bool replace) {
+        if (slots[id] == 0) {
+            values.push_back(std::move(value));
+            slots[id] = values.size();
+
+        } else if (replace) {
+            values[slots[id] - 1] = std::move(value);
+        }
+    }
+
+    bool CMDParser::parseList(const Option &opt) {
+        owc_key_list keys;
+        owc_time_list times;
+        const bool valid = forEachItem(argV[1], [&opt, &keys, &times](const std::string_view item)->bool {
+            bool added;
+
+            if (opt.type == OptionType::KeyList) {
+                const std::string *key = KeyTable::getHID().resolve(item);
+
+                if (!key) {
+                    std::cerr << "unknown key " << item << " for " << opt.name << "\n";
+                    return false;
+                }
+
+                added = keys.add(key);
+
+            } else {
+                int time;
+
+                if (!parseInt(item, time)) {
+                    std::cerr << "invalid time " << item << " for " << opt.name << "\n";
+                    return false;
+                }
+
+                added = times.add(time);
+            }
+
+            if (!added)
+                std::cerr << opt.name << " takes at most " << ConfigImage::Slots << " values\n";
+
+            return added;
+        });
+
+        if (!valid)
+            return false;
+
+        if (opt.type == OptionType::KeyList)
+            store(&opt - Options.data(), keys, false);
+        else
+            store(&opt - Options.data(), times, false);
+
+        return true;
+    }
+
     bool CMDParser::parseSetOptions() {
         if (argC < 1) {
             showHelp();
@@ -253,66 +287,225 @@ namespace OWC {
         }
 
         while (argC > 0) {
-            if (isArg("du") || isArg("dd") || isArg("dl") || isArg("dr") ||
-                isArg("a") || isArg("b") || isArg("x") || isArg("y") ||
-                isArg("lu") || isArg("ld") || isArg("ll") || isArg("lr") ||
-                isArg("st") || isArg("sl") || isArg("mu") || isArg("l1") ||
-                isArg("l2") || isArg("l3") || isArg("r1") || isArg("r2") ||
-                isArg("r3") || isArg("xdu") || isArg("xdd") || isArg("xdl") ||
-                isArg("xdr") || isArg("xa") || isArg("xb") || isArg("xx") ||
-                isArg("xy") || isArg("xst") || isArg("xsl") || isArg("xmu") ||
-                isArg("xlu") || isArg("xld") || isArg("xll") || isArg("xlr") ||
-                isArg("xru") || isArg("xrd") || isArg("xrl") || isArg("xrr") ||
-                isArg("xl1") || isArg("xl2") || isArg("xl3") || isArg("xr1") ||
-                isArg("xr2") || isArg("xr3"))
-            {
-                std::string key = argV[1];
-
-                std::erase_if(key, [](const char c)->bool { return std::isspace(c); });
-                args.emplace(argV[0], key);
-
-            } else if (isArg("l4") || isArg("r4") || isArg("l5") || isArg("r5")) {
-                std::vector<std::string> keys;
-                char *s = strtok(argV[1], ",");
-
-                while (s != nullptr) {
-                    keys.emplace_back(s);
-                    s = strtok(nullptr, ",");
+            const Option *opt = findOption(argV[0]);
+            int id;
+
+            if (!opt) {
+                std::cerr << "unknown option " << argV[0] << "\n";
+                return false;
+
+            } else if (argC < 2) {
+                std::cerr << "missing value for " << argV[0] << "\n";
+                return false;
+            }
+
+            id = opt - Options.data();
+
+            switch (opt->type) {
+                case OptionType::Key:
+                case OptionType::XinputKey: {
+                    const KeyTable &table = opt->type == OptionType::Key ? KeyTable::getHID() : KeyTable::getXinput();
+                    std::string_view arg = argV[1];
+                    const std::string *key;
+
+                    arg.remove_prefix(std::min(arg.find_first_not_of(" \t"), arg.size()));
+                    arg.remove_suffix(arg.size() - (arg.find_last_not_of(" \t") + 1));
+
+                    key = table.resolve(arg);
+                    if (!key) {
+                        std::cerr << "unknown key " << arg << " for " << opt->name << "\n";
+                        return false;
+                    }
+
+                    store(id, key, false);
+                }
+                    break;
+                case OptionType::KeyList:
+                case OptionType::TimeList:
+                    if (!parseList(*opt))
+                        return false;
+                    break;
+                case OptionType::Macro: {
+                    Macro macro;
+                    std::string error;
+
+                    // the V1 slot budget is checked once the controller is known
+                    if (!MacroCompiler::compile(argV[1], 0, macro, error)) {
+                        std::cerr << opt->name << ": " << error << "\n";
+                        return false;
+                    }
+
+                    store(id, std::string_view(argV[1]), false);
+                }
+                    break;
+                case OptionType::Int: {
+                    int val;
+
+                    if (!parseInt(argV[1], val) || val < opt->minVal || val > opt->maxVal) {
+                        std::cerr << opt->name << " must be in [" << opt->minVal << ", " << opt->maxVal << "]\n";
+                        return false;
+                    }
+
+                    store(id, val, false);
+                }
+                    break;
+                case OptionType::Color: {
+                    const std::string_view arg = argV[1];
+                    std::array<int, 3> rgb {};
+                    bool valid = true;
+
+                    // r:g:b
+                    for (size_t i=0, start=0, end; i<rgb.size() && valid; ++i, start=end + 1) {
+                        end = i + 1 < rgb.size() ? arg.find(':', start) : arg.size();
+                        valid = end != std::string_view::npos && parseInt(arg.substr(start, end - start), rgb[i]) && rgb[i] >= opt->minVal && rgb[i] <= opt->maxVal;
+                    }
+
+                    if (!valid) {
+                        std::cerr << "invalid " << opt->name << " value\n";
+                        return false;
+                    }
+
+                    store(id, std::make_tuple(rgb[0], rgb[1], rgb[2]), false);
                 }
+                    break;
+            }
+
+            argC -= 2;
+            argV += 2;
+        }
+
+        return true;
+    }
+
+    bool CMDParser::parsePrintOptions() {
+        while (argC > 0) {
+            if (isArg("--active-only")) {
+                store(argV[0], 0, false);
+                --argC;
+                ++argV;
+                continue;
+
+            } else if (!isArg("--section") && !isArg("--button")) {
+                std::cerr << "unknown print option " << argV[0] << "\n";
+                return false;
+
+            } else if (argC < 2) {
+                std::cerr << "missing value for " << argV[0] << "\n";
+                return false;
+            }
 
-                args.emplace(argV[0], keys);
+            if (isArg("--section")) {
+                int sections = 0;
+                const bool valid = forEachItem(argV[1], [&sections](const std::string_view name)->bool {
+                    const auto it = std::ranges::find(PrintSections, name);
 
-            } else if (isArg("l4d") || isArg("l4h") || isArg("r4d") || isArg("r4h") ||
-                       isArg("l5d") || isArg("l5h") || isArg("r5d") || isArg("r5h"))
-            {
-                std::vector<int> times;
-                char *s = strtok(argV[1], ",");
+                    if (it == PrintSections.end()) {
+                        std::cerr << "unknown section " << name << "\n";
+                        return false;
+                    }
 
-                while (s != nullptr) {
-                    times.emplace_back(std::stoi(s));
+                    sections |= 1 << (it - PrintSections.begin());
+                    return true;
+                });
 
-                    s = strtok(nullptr, ",");
+                if (!valid)
+                    return false;
+
+                store(argV[0], sections);
+
+            } else {
+                const int btn = findBackButton(argV[1]);
+
+                if (!btn) {
+                    std::cerr << "unknown back button " << argV[1] << "\n";
+                    return false;
                 }
 
-                args.emplace(argV[0], times);
+                store(argV[0], btn);
+            }
+
+            argC -= 2;
+            argV += 2;
+        }
 
-            } else if (isArg("lc") || isArg("lb") || isArg("rc") || isArg("rb") ||
-                       isArg("led") || isArg("rmb") || isArg("l4n") || isArg("r4n") ||
-                       isArg("l5n") || isArg("r5n"))
-            {
-                args.emplace(argV[0], std::stoi(argV[1]));
+        return true;
+    }
 
-            } else if (isArg("ledclr")) {
-                int r, g, b;
+    bool CMDParser::parseWriteOptions() {
+        while (argC > 0) {
+            if (!isArg("--fsync")) {
+                std::cerr << "unknown option " << argV[0] << "\n";
+                return false;
+            }
+
+            store(argV[0], 0, false);
+            --argC;
+            ++argV;
+        }
+
+        return true;
+    }
+
+    bool CMDParser::parseBulkOptions(const bool write) {
+        while (argC > 0) {
+            if (write && isArg("--fsync")) {
+                store(argV[0], 0, false);
+                --argC;
+                ++argV;
+                continue;
+
+            } else if (!isArg("--jobs") && !isArg("--report") && !(write && isArg("--to"))) {
+                std::cerr << "unknown option " << argV[0] << "\n";
+                return false;
+
+            } else if (argC < 2) {
+                std::cerr << "missing value for " << argV[0] << "\n";
+                return false;
+            }
 
-                if (std::sscanf(argV[1], "%d:%d:%d", &r, &g, &b) != 3) {
-                    std::cerr << "invalid ledclr value\n";
+            if (isArg("--jobs")) {
+                int jobs;
+
+                if (!parseInt(argV[1], jobs) || jobs < 1) {
+                    std::cerr << "invalid jobs count " << argV[1] << "\n";
                     return false;
                 }
 
-                args.emplace(argV[1], std::make_tuple(r, g ,b));
+                store(argV[0], jobs);
+
+            } else if (isArg("--to") && std::string_view(argV[1]) != "yaml" && std::string_view(argV[1]) != "owcb") {
+                std::cerr << "unknown format " << argV[1] << ", must be yaml or owcb\n";
+                return false;
+
+            } else {
+                store(argV[0], std::string_view(argV[1]));
+            }
+
+            argC -= 2;
+            argV += 2;
+        }
+
+        return true;
+    }
+
+    bool CMDParser::parseSwitchOptions() {
+        while (argC > 0) {
+            int poll;
+
+            if (!isArg("--poll")) {
+                std::cerr << "unknown option " << argV[0] << "\n";
+                return false;
+
+            } else if (argC < 2) {
+                std::cerr << "missing value for " << argV[0] << "\n";
+                return false;
+
+            } else if (!parseInt(argV[1], poll) || poll < 10) {
+                std::cerr << "poll interval must be at least 10 ms\n";
+                return false;
             }
 
+            store(argV[0], poll);
             argC -= 2;
             argV += 2;
         }
@@ -320,7 +513,105 @@ namespace OWC {
         return true;
     }
 
+    bool CMDParser::parseSimulateOptions() {
+        while (argC > 0) {
+            if (isArg("--json")) {
+                store(argV[0], 0, false);
+                --argC;
+                ++argV;
+                continue;
+
+            } else if (!isArg("--profile") && !isArg("--macro")) {
+                std::cerr << "unknown simulate option " << argV[0] << "\n";
+                return false;
+
+            } else if (argC < 2) {
+                std::cerr << "missing value for " << argV[0] << "\n";
+                return false;
+            }
+
+            store(argV[0], std::string_view(argV[1]));
+            argC -= 2;
+            argV += 2;
+        }
+
+        if (hasArg("--profile") && hasArg("--macro")) {
+            std::cerr << "--profile and --macro cannot be used together\n";
+            return false;
+        }
+
+        return true;
+    }
+
+    bool CMDParser::parseGlobalOptions() {
+        while (argC > 0 && std::string_view(argV[0]).starts_with("--")) {
+            if (isArg("--no-cache")) {
+                store(argV[0], 0, false);
+
+            } else if (isArg("--timings") || isArg("--verify")) {
+                store(argV[0], 0, false);
+
+            } else if (isArg("--retry")) {
+                int retry;
+
+                if (argC < 2 || !parseInt(argV[1], retry) || retry < 1 || retry > 10) {
+                    std::cerr << "--retry must be between 1 and 10\n";
+                    return false;
+                }
+
+                store(argV[0], retry);
+                --argC;
+                ++argV;
+
+            } else if (isArg("--replay-speed")) {
+                if (argC < 2 || (std::string_view(argV[1]) != "fast" && std::string_view(argV[1]) != "real")) {
+                    std::cerr << "--replay-speed must be fast or real\n";
+                    return false;
+                }
+
+                store(argV[0], std::string_view(argV[1]));
+                --argC;
+                ++argV;
+
+            } else if (isArg("--trace") || isArg("--record") || isArg("--replay")) {
+                if (argC < 2) {
+                    std::cerr << "missing value for " << argV[0] << "\n";
+                    return false;
+                }
+
+                store(argV[0], std::string_view(argV[1]));
+                --argC;
+                ++argV;
+
+            } else {
+                std::cerr << "unknown option " << argV[0] << "\n";
+                return false;
+            }
+
+            --argC;
+            ++argV;
+        }
+
+        if (hasArg("--record") && hasArg("--replay")) {
+            std::cerr << "--record and --replay cannot be used together\n";
+            return false;
+
+        } else if (hasArg("--replay-speed") && !hasArg("--replay")) {
+            std::cerr << "--replay-speed needs --replay\n";
+            return false;
+
+        } else if (hasArg("--retry") && !hasArg("--verify")) {
+            std::cerr << "--retry needs --verify\n";
+            return false;
+        }
+
+        return true;
+    }
+
     bool CMDParser::parse() {
+        if (!parseGlobalOptions())
+            return false;
+
         if (argC < 1 || isArg("help")) {
             showHelp();
             return false;
@@ -333,16 +624,93 @@ namespace OWC {
             showXKeys();
             return false;
 
-        } else if (isArg("print") || isArg("reset")) {
-            args.emplace(argV[0], 0);
+        } else if (isArg("print")) {
+            store(argV[0], 0, false);
+            --argC;
+            ++argV;
+            return parsePrintOptions();
+
+        } else if (isArg("simulate")) {
+            int btn;
+
+            if (argC < 2) {
+                showHelp();
+                return false;
+            }
+
+            btn = findBackButton(argV[1]);
+            if (!btn) {
+                std::cerr << "unknown back button " << argV[1] << "\n";
+                return false;
+            }
+
+            store(argV[0], btn, false);
+            argC -= 2;
+            argV += 2;
+            return parseSimulateOptions();
+
+        } else if (isArg("reset") || isArg("daemon") || isArg("devices")) {
+            store(argV[0], 0, false);
             return true;
 
-        } else if (isArg("export") || isArg("import")) {
-            args.emplace(argV[0], argV[1]);
+        } else if (isArg("autoswitch")) {
+            if (argC < 2) {
+                showHelp();
+                return false;
+            }
+
+            store(argV[0], std::string_view(argV[1]), false);
+            argC -= 2;
+            argV += 2;
+            return parseSwitchOptions();
+
+        } else if (isArg("import") || isArg("batch") || isArg("watch")) {
+            if (argC < 2) {
+                showHelp();
+                return false;
+            }
+
+            store(argV[0], std::string_view(argV[1]), false);
             return true;
 
+        } else if (isArg("export")) {
+            if (argC < 2) {
+                showHelp();
+                return false;
+            }
+
+            store(argV[0], std::string_view(argV[1]), false);
+            argC -= 2;
+            argV += 2;
+            return parseWriteOptions();
+
+        } else if (isArg("convert")) {
+            if (argC < 3) {
+                showHelp();
+                return false;
+            }
+
+            store(argV[0], std::vector<std::string_view> {argV[1], argV[2]}, false);
+            argC -= 3;
+            argV += 3;
+            return parseBulkOptions(true);
+
+        } else if (isArg("validate")) {
+            std::vector<std::string_view> paths;
+
+            for (--argC, ++argV; argC > 0 && !std::string_view(argV[0]).starts_with("--"); --argC, ++argV)
+                paths.emplace_back(argV[0]);
+
+            if (paths.empty()) {
+                showHelp();
+                return false;
+            }
+
+            store("validate", std::move(paths), false);
+            return parseBulkOptions(false);
+
         } else if (isArg("set")) {
-            args.emplace(argV[0], 0);
+            store(argV[0], 0, false);
             --argC;
             ++argV;
             return parseSetOptions();
@@ -17,31 +17,90 @@
  */
 #pragma once
 
-#include <map>
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <variant>
 #include <vector>
 
+#include "ConfigImage.h"
+#include "../include/Options.h"
+
 namespace OWC {
-    typedef std::variant<std::string, int, std::tuple<int, int, int>, std::vector<std::string>, std::vector<int>> owc_arg_value;
+    // fixed capacity vector stored in place, for the back button slot lists
+    template<typename T, size_t N>
+    class InlineVector final {
+    private:
+        std::array<T, N> items {};
+        size_t count = 0;
+
+    public:
+        [[nodiscard]] bool add(const T &item) {
+            if (count == N)
+                return false;
+
+            items[count++] = item;
+            return true;
+        }
+
+        [[nodiscard]] size_t size() const { return count; }
+        [[nodiscard]] const T &operator[](const size_t i) const { return items[i]; }
+        [[nodiscard]] const T *begin() const { return items.data(); }
+        [[nodiscard]] const T *end() const { return items.data() + count; }
+    };
+
+    typedef InlineVector<const std::string *, ConfigImage::Slots> owc_key_list;
+    typedef InlineVector<int, ConfigImage::Slots> owc_time_list;
+
+    // strings are views into argv, which must outlive the parser, keys point to the KeyTable names
+    typedef std::variant<std::string_view, int, std::tuple<int, int, int>, const std::string *, owc_key_list, owc_time_list, std::vector<std::string_view>> owc_arg_value;
 
     class CMDParser final {
     private:
-        std::map<std::string, owc_arg_value> args;
-        char **argV;
+        // commands and flags, their ids follow the Options ids
+        static constexpr std::array<std::string_view, 32> ArgNames = {
+            "print", "set", "reset", "daemon", "devices", "autoswitch", "import", "batch", "watch", "export", "convert", "validate", "simulate",
+            "--no-cache", "--timings", "--verify", "--retry", "--replay-speed", "--trace", "--record", "--replay",
+            "--active-only", "--section", "--button", "--fsync", "--jobs", "--report", "--to", "--poll", "--json", "--profile", "--macro"
+        };
+        static constexpr size_t ArgCount = Options.size() + ArgNames.size();
+
+        // arg id -> index + 1 in values, 0 if not given
+        std::array<uint8_t, ArgCount> slots {};
+        std::vector<owc_arg_value> values;
+        const char *const *argV;
         int argC;
 
+        static_assert(ArgCount < UINT8_MAX);
+
+        [[nodiscard]] static int argId(std::string_view arg);
+        [[nodiscard]] static bool parseInt(std::string_view str, int &out);
         void showHelp() const;
         void showKeys() const;
         void showXKeys() const;
         [[nodiscard]] bool isArg(std::string_view arg) const;
+        void store(int id, owc_arg_value &&value, bool replace);
+        void store(std::string_view arg, owc_arg_value &&value, bool replace = true) { store(argId(arg), std::move(value), replace); }
+        [[nodiscard]] bool parseList(const Option &opt);
         [[nodiscard]] bool parseSetOptions();
+        [[nodiscard]] bool parsePrintOptions();
+        [[nodiscard]] bool parseWriteOptions();
+        [[nodiscard]] bool parseBulkOptions(bool write);
+        [[nodiscard]] bool parseSwitchOptions();
+        [[nodiscard]] bool parseSimulateOptions();
+        [[nodiscard]] bool parseGlobalOptions();
 
     public:
-        CMDParser(int argc, char *argv[]);
+        CMDParser(int argc, const char *const argv[]);
 
         [[nodiscard]] bool parse();
-        [[nodiscard]] bool hasArg(const std::string &arg) const { return args.contains(arg); }
-        [[nodiscard]] owc_arg_value getValue(const std::string &arg) const { return args.at(arg); }
+        [[nodiscard]] bool hasArg(std::string_view arg) const;
+        [[nodiscard]] bool hasArg(const Option &opt) const { return slots[&opt - Options.data()] != 0; }
+
+        // the arg must be present, see hasArg
+        [[nodiscard]] const owc_arg_value &getValue(std::string_view arg) const { return values[slots[argId(arg)] - 1]; }
+        [[nodiscard]] const owc_arg_value &getValue(const Option &opt) const { return values[slots[&opt - Options.data()] - 1]; }
     };
 }
@@ -0,0 +1,143 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <format>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ConfigCache.h"
+#include "../version.h"
+
+namespace OWC {
+    ConfigCache *ConfigCache::getInstance() {
+        if (!instance)
+            instance = new ConfigCache();
+
+        return instance;
+    }
+
+    std::filesystem::path ConfigCache::getCacheDir() {
+#ifdef _WIN32
+        const char *localAppData = std::getenv("LOCALAPPDATA");
+
+        if (localAppData && *localAppData)
+            return std::filesystem::path(localAppData) / APP_NAME;
+#else
+        const char *xdgCache = std::getenv("XDG_CACHE_HOME");
+        const char *home = std::getenv("HOME");
+
+        if (xdgCache && *xdgCache)
+            return std::filesystem::path(xdgCache) / APP_NAME;
+        else if (home && *home)
+            return std::filesystem::path(home) / ".cache" / APP_NAME;
+#endif
+
+        return {};
+    }
+
+    std::string ConfigCache::getBootId() {
+#ifdef __linux__
+        std::ifstream bootIdF ("/proc/sys/kernel/random/boot_id");
+        std::string bootId;
+
+        if (bootIdF.is_open())
+            std::getline(bootIdF, bootId);
+
+        return bootId;
+#else
+        return "";
+#endif
+    }
+
+    void ConfigCache::init(const std::string &product, const std::string &version, const bool enable) {
+        const std::filesystem::path dir = getCacheDir();
+        std::string bootId;
+
+        if (dir.empty() || product.empty())
+            return;
+
+        // the firmware has no config checksum or generation counter, a reboot is the best proxy for external changes
+        cacheFile = dir / (product + ".cache");
+        // without a boot id an entry would never expire, Windows has the GPD tool writing the same config
+        bootId = getBootId();
+        key = "OWC1 " + product + " " + version + " " + bootId;
+        enabled = enable && !bootId.empty();
+    }
+
+    bool ConfigCache::load(ConfigImage &img) const {
+        std::ifstream cacheF;
+        std::stringstream data;
+        std::string header;
+
+        if (!enabled)
+            return false;
+
+        cacheF.open(cacheFile, std::ios::binary);
+        if (!cacheF.is_open() || !std::getline(cacheF, header) || header != key)
+            return false;
+
+        data << cacheF.rdbuf();
+        return ConfigImage::deserialize(data.view(), img);
+    }
+
+    void ConfigCache::store(const ConfigImage &img) const {
+        std::filesystem::path tmpFile;
+        std::error_code ec;
+        std::ofstream cacheF;
+
+        if (!enabled)
+            return;
+
+        std::filesystem::create_directories(cacheFile.parent_path(), ec);
+        if (ec)
+            return;
+
+        // concurrent instances must not share the temp file
+        tmpFile = cacheFile;
+#ifdef _WIN32
+        tmpFile += std::format(".{}.tmp", _getpid());
+#else
+        tmpFile += std::format(".{}.tmp", getpid());
+#endif
+
+        cacheF.open(tmpFile, std::ios::binary | std::ios::trunc);
+        if (!cacheF.is_open())
+            return;
+
+        cacheF << key << "\n" << img.serialize();
+        cacheF.close();
+
+        if (cacheF.fail())
+            std::filesystem::remove(tmpFile, ec);
+        else
+            std::filesystem::rename(tmpFile, cacheFile, ec);
+    }
+
+    void ConfigCache::invalidate() const {
+        std::error_code ec;
+
+        // also with --no-cache, the device is about to change
+        if (!cacheFile.empty())
+            std::filesystem::remove(cacheFile, ec);
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "ConfigImage.h"
+
+namespace OWC {
+    /*
+     * Last config read from the device, used to answer read-only commands without a full readConfig
+     *
+     * An entry is valid for the same board, firmware version and boot, any write from this tool removes it.
+     * Writes from other tools during the same boot are not detected, the library can only read the whole config.
+     * Disabled where there is no boot id (anything but Linux).
+     */
+    class ConfigCache final {
+    private:
+        static inline ConfigCache *instance = nullptr;
+        std::filesystem::path cacheFile;
+        std::string key;
+        bool enabled = false;
+
+        ConfigCache() = default;
+
+        [[nodiscard]] static std::filesystem::path getCacheDir();
+        [[nodiscard]] static std::string getBootId();
+
+    public:
+        ConfigCache(ConfigCache &) = delete;
+
+        static ConfigCache *getInstance();
+        void init(const std::string &product, const std::string &version, bool enable);
+        [[nodiscard]] bool load(ConfigImage &img) const;
+        void store(const ConfigImage &img) const;
+        void invalidate() const;
+    };
+}
@@ -0,0 +1,520 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <format>
+
+#include "ConfigImage.h"
+#include "../extern/libOpenWinControls/src/include/ControllerFeature.h"
+#include "../extern/libOpenWinControls/src/controller/ControllerV2.h"
+
+namespace OWC {
+    static constexpr int firstBackButtonField = ConfigImage::KbmFields + ConfigImage::XinputFields;
+
+    [[nodiscard]]
+    static bool isBackButtonImplemented(const std::shared_ptr<Controller> &gpd, const int num) {
+        if (gpd->getControllerType() == 1)
+            return num <= 2;
+        else if (num == 3)
+            return gpd->hasFeature(ControllerFeature::BackButton3);
+        else if (num == 4)
+            return gpd->hasFeature(ControllerFeature::BackButton4);
+
+        return true;
+    }
+
+    static void hashBytes(uint32_t &hash, const void *data, const size_t len) {
+        const uint8_t *p = static_cast<const uint8_t *>(data);
+
+        for (size_t i=0; i<len; ++i) {
+            hash ^= p[i];
+            hash *= 16777619u;
+        }
+    }
+
+    static void appendInt(std::string &out, const int32_t val) {
+        out.append(reinterpret_cast<const char *>(&val), sizeof(val));
+    }
+
+    static void appendString(std::string &out, const std::string &str) {
+        out.push_back(static_cast<char>(std::min<size_t>(str.size(), 255)));
+        out.append(str, 0, 255);
+    }
+
+    [[nodiscard]]
+    static bool readInt(std::string_view &in, int &val) {
+        int32_t v;
+
+        if (in.size() < sizeof(v))
+            return false;
+
+        std::memcpy(&v, in.data(), sizeof(v));
+        in.remove_prefix(sizeof(v));
+        val = v;
+        return true;
+    }
+
+    [[nodiscard]]
+    static bool readString(std::string_view &in, std::string &str) {
+        size_t len;
+
+        if (in.empty())
+            return false;
+
+        len = static_cast<uint8_t>(in[0]);
+        if (in.size() < len + 1)
+            return false;
+
+        str.assign(in.substr(1, len));
+        in.remove_prefix(len + 1);
+        return true;
+    }
+
+    ConfigBlock ConfigImage::fieldBlock(const int field) {
+        if (field < KbmFields)
+            return ConfigBlock::KeyboardMouse;
+        else if (field < firstBackButtonField)
+            return ConfigBlock::Xinput;
+        else if (field < fieldActiveSlots(1))
+            return static_cast<ConfigBlock>(static_cast<int>(ConfigBlock::BackButton1) + (field - firstBackButtonField) / (Slots * 3));
+        else if (field < fieldRumble())
+            return static_cast<ConfigBlock>(static_cast<int>(ConfigBlock::BackButton1) + (field - fieldActiveSlots(1)));
+        else if (field == fieldRumble())
+            return ConfigBlock::Rumble;
+        else if (field < fieldLedMode())
+            return ConfigBlock::DeadZone;
+
+        return ConfigBlock::Leds;
+    }
+
+    std::string_view ConfigImage::blockToString(const ConfigBlock block) {
+        switch (block) {
+            case ConfigBlock::KeyboardMouse:
+                return "keyboard&mouse mapping";
+            case ConfigBlock::Xinput:
+                return "xinput mapping";
+            case ConfigBlock::BackButton1:
+                return "L4 back button";
+            case ConfigBlock::BackButton2:
+                return "R4 back button";
+            case ConfigBlock::BackButton3:
+                return "L5 back button";
+            case ConfigBlock::BackButton4:
+                return "R5 back button";
+            case ConfigBlock::Rumble:
+                return "rumble";
+            case ConfigBlock::DeadZone:
+                return "deadzone";
+            case ConfigBlock::Leds:
+                return "shoulder leds";
+            default:
+                return "";
+        }
+    }
+
+    ConfigImage ConfigImage::capture(const std::shared_ptr<Controller> &gpd) {
+        const std::shared_ptr<ControllerV2> gpdV2 = std::dynamic_pointer_cast<ControllerV2>(gpd);
+        const int slots = gpdV2 ? Slots : 4;
+        ConfigImage img;
+
+        img.controllerType = gpd->getControllerType();
+
+        for (int i=0; i<KbmFields; ++i) {
+            img.kbm[i] = gpd->getButton(KbmButtons[i].second);
+            img.present.set(fieldKbm(i));
+        }
+
+        if (gpd->hasFeature(ControllerFeature::XinputMappingV1)) {
+            for (int i=0; i<XinputFields; ++i) {
+                img.xinput[i] = gpd->getButton(XinputButtons[i].second);
+                img.present.set(fieldXinput(i));
+            }
+        }
+
+        for (int num=1; num<=BackButtons; ++num) {
+            if (!isBackButtonImplemented(gpd, num))
+                continue;
+
+            for (int slot=1; slot<=slots; ++slot) {
+                img.backButtonKeys[num - 1][slot - 1] = gpd->getBackButton(num, slot);
+                img.backButtonStartTimes[num - 1][slot - 1] = gpd->getBackButtonStartTime(num, slot);
+                img.present.set(fieldBackButton(num, slot, SlotField::Key));
+                img.present.set(fieldBackButton(num, slot, SlotField::StartTime));
+
+                if (gpdV2) {
+                    img.backButtonHoldTimes[num - 1][slot - 1] = gpdV2->getBackButtonHoldTime(num, slot);
+                    img.present.set(fieldBackButton(num, slot, SlotField::HoldTime));
+                }
+            }
+
+            if (gpdV2) {
+                img.activeSlots[num - 1] = gpdV2->getBackButtonActiveSlots(num);
+                img.present.set(fieldActiveSlots(num));
+            }
+        }
+
+        if (gpd->hasFeature(ControllerFeature::RumbleV1)) {
+            img.rumble = static_cast<int>(gpd->getRumbleMode());
+            img.present.set(fieldRumble());
+        }
+
+        if (gpd->hasFeature(ControllerFeature::DeadZoneControlV1)) {
+            img.deadZone = {gpd->getAnalogCenter(true), gpd->getAnalogBoundary(true), gpd->getAnalogCenter(false), gpd->getAnalogBoundary(false)};
+
+            for (int i=0; i<4; ++i)
+                img.present.set(fieldDeadZone(static_cast<DeadZoneField>(i)));
+        }
+
+        if (gpd->hasFeature(ControllerFeature::ShoulderLedsV1)) {
+            img.ledMode = static_cast<int>(gpd->getLedMode());
+            img.ledColor = gpd->getLedColor();
+            img.present.set(fieldLedMode());
+            img.present.set(fieldLedColor());
+        }
+
+        return img;
+    }
+
+    void ConfigImage::apply(const std::shared_ptr<Controller> &gpd) const {
+        const std::shared_ptr<ControllerV2> gpdV2 = std::dynamic_pointer_cast<ControllerV2>(gpd);
+
+        for (int i=0; i<KbmFields; ++i) {
+            if (present.test(fieldKbm(i)))
+                gpd->setButton(KbmButtons[i].second, kbm[i]);
+        }
+
+        if (gpd->hasFeature(ControllerFeature::XinputMappingV1)) {
+            for (int i=0; i<XinputFields; ++i) {
+                if (present.test(fieldXinput(i)))
+                    gpd->setButton(XinputButtons[i].second, xinput[i]);
+            }
+        }
+
+        for (int num=1; num<=BackButtons; ++num) {
+            if (!isBackButtonImplemented(gpd, num))
+                continue;
+
+            for (int slot=1, slots=(gpdV2 ? Slots : 4); slot<=slots; ++slot) {
+                if (present.test(fieldBackButton(num, slot, SlotField::Key)))
+                    gpd->setBackButton(num, slot, backButtonKeys[num - 1][slot - 1]);
+
+                if (present.test(fieldBackButton(num, slot, SlotField::StartTime)))
+                    gpd->setBackButtonStartTime(num, slot, backButtonStartTimes[num - 1][slot - 1]);
+
+                if (gpdV2 && present.test(fieldBackButton(num, slot, SlotField::HoldTime)))
+                    gpdV2->setBackButtonHoldTime(num, slot, backButtonHoldTimes[num - 1][slot - 1]);
+            }
+
+            if (gpdV2 && present.test(fieldActiveSlots(num)))
+                gpdV2->setBackButtonActiveSlots(num, activeSlots[num - 1]);
+        }
+
+        if (gpd->hasFeature(ControllerFeature::RumbleV1) && present.test(fieldRumble()))
+            gpd->setRumble(static_cast<RumbleMode>(rumble));
+
+        if (gpd->hasFeature(ControllerFeature::DeadZoneControlV1)) {
+            if (present.test(fieldDeadZone(DeadZoneField::LeftCenter)))
+                gpd->setAnalogCenter(deadZone[0], true);
+
+            if (present.test(fieldDeadZone(DeadZoneField::LeftBoundary)))
+                gpd->setAnalogBoundary(deadZone[1], true);
+
+            if (present.test(fieldDeadZone(DeadZoneField::RightCenter)))
+                gpd->setAnalogCenter(deadZone[2], false);
+
+            if (present.test(fieldDeadZone(DeadZoneField::RightBoundary)))
+                gpd->setAnalogBoundary(deadZone[3], false);
+        }
+
+        if (gpd->hasFeature(ControllerFeature::ShoulderLedsV1)) {
+            if (present.test(fieldLedMode()))
+                gpd->setLedMode(static_cast<LedMode>(ledMode));
+
+            if (present.test(fieldLedColor()))
+                gpd->setLedColor(std::get<0>(ledColor), std::get<1>(ledColor), std::get<2>(ledColor));
+        }
+    }
+
+    bool ConfigImage::fieldEquals(const ConfigImage &other, const int field) const {
+        if (field < KbmFields)
+            return kbm[field] == other.kbm[field];
+        else if (field < firstBackButtonField)
+            return xinput[field - KbmFields] == other.xinput[field - KbmFields];
+
+        if (field < fieldActiveSlots(1)) {
+            const int idx = field - firstBackButtonField;
+            const int num = idx / (Slots * 3);
+            const int slot = (idx / 3) % Slots;
+
+            switch (static_cast<SlotField>(idx % 3)) {
+                case SlotField::Key:
+                    return backButtonKeys[num][slot] == other.backButtonKeys[num][slot];
+                case SlotField::StartTime:
+                    return backButtonStartTimes[num][slot] == other.backButtonStartTimes[num][slot];
+                case SlotField::HoldTime:
+                    return backButtonHoldTimes[num][slot] == other.backButtonHoldTimes[num][slot];
+            }
+        }
+
+        if (field < fieldRumble())
+            return activeSlots[field - fieldActiveSlots(1)] == other.activeSlots[field - fieldActiveSlots(1)];
+        else if (field == fieldRumble())
+            return rumble == other.rumble;
+        else if (field < fieldLedMode())
+            return deadZone[field - fieldDeadZone(DeadZoneField::LeftCenter)] == other.deadZone[field - fieldDeadZone(DeadZoneField::LeftCenter)];
+        else if (field == fieldLedMode())
+            return ledMode == other.ledMode;
+
+        return ledColor == other.ledColor;
+    }
+
+    int ConfigImage::diff(const ConfigImage &other) const {
+        int dirty = 0;
+
+        for (int i=0; i<FieldCount; ++i) {
+            const bool has = present.test(i);
+
+            if (has != other.present.test(i) || (has && !fieldEquals(other, i)))
+                dirty |= 1 << static_cast<int>(fieldBlock(i));
+        }
+
+        return dirty;
+    }
+
+    std::bitset<ConfigImage::FieldCount> ConfigImage::changedFields(const ConfigImage &other) const {
+        std::bitset<FieldCount> changed;
+
+        for (int i=0; i<FieldCount; ++i) {
+            if (present.test(i) && (!other.present.test(i) || !fieldEquals(other, i)))
+                changed.set(i);
+        }
+
+        return changed;
+    }
+
+    std::string ConfigImage::serialize() const {
+        std::string out;
+
+        appendInt(out, controllerType);
+
+        for (int i=0; i<FieldCount; i+=8) {
+            uint8_t bits = 0;
+
+            for (int b=0; b<8 && (i + b)<FieldCount; ++b)
+                bits |= present.test(i + b) << b;
+
+            out.push_back(static_cast<char>(bits));
+        }
+
+        for (const std::string &key: kbm)
+            appendString(out, key);
+
+        for (const std::string &key: xinput)
+            appendString(out, key);
+
+        for (int num=0; num<BackButtons; ++num) {
+            for (int slot=0; slot<Slots; ++slot) {
+                appendString(out, backButtonKeys[num][slot]);
+                appendInt(out, backButtonStartTimes[num][slot]);
+                appendInt(out, backButtonHoldTimes[num][slot]);
+            }
+
+            appendInt(out, activeSlots[num]);
+        }
+
+        appendInt(out, rumble);
+
+        for (const int val: deadZone)
+            appendInt(out, val);
+
+        appendInt(out, ledMode);
+        appendInt(out, std::get<0>(ledColor));
+        appendInt(out, std::get<1>(ledColor));
+        appendInt(out, std::get<2>(ledColor));
+
+        return out;
+    }
+
+    bool ConfigImage::deserialize(std::string_view data, ConfigImage &img) {
+        constexpr size_t presentSz = (FieldCount + 7) / 8;
+        ConfigImage tmp;
+        int r, g, b;
+
+        if (!readInt(data, tmp.controllerType) || data.size() < presentSz)
+            return false;
+
+        for (int i=0; i<FieldCount; ++i)
+            tmp.present.set(i, (static_cast<uint8_t>(data[i / 8]) >> (i % 8)) & 1);
+
+        data.remove_prefix(presentSz);
+
+        for (std::string &key: tmp.kbm) {
+            if (!readString(data, key))
+                return false;
+        }
+
+        for (std::string &key: tmp.xinput) {
+            if (!readString(data, key))
+                return false;
+        }
+
+        for (int num=0; num<BackButtons; ++num) {
+            for (int slot=0; slot<Slots; ++slot) {
+                if (!readString(data, tmp.backButtonKeys[num][slot]) || !readInt(data, tmp.backButtonStartTimes[num][slot]) || !readInt(data, tmp.backButtonHoldTimes[num][slot]))
+                    return false;
+            }
+
+            if (!readInt(data, tmp.activeSlots[num]))
+                return false;
+        }
+
+        if (!readInt(data, tmp.rumble))
+            return false;
+
+        for (int &val: tmp.deadZone) {
+            if (!readInt(data, val))
+                return false;
+        }
+
+        if (!readInt(data, tmp.ledMode) || !readInt(data, r) || !readInt(data, g) || !readInt(data, b) || !data.empty())
+            return false;
+
+        tmp.ledColor = {r, g, b};
+        img = std::move(tmp);
+        return true;
+    }
+
+    std::string ConfigImage::fieldName(const int field) {
+        constexpr std::array<std::string_view, BackButtons> backButtons = {"L4", "R4", "L5", "R5"};
+        constexpr std::array<std::string_view, 4> deadZoneNames = {"LEFT_ANALOG_CENTER", "LEFT_ANALOG_BOUNDARY", "RIGHT_ANALOG_CENTER", "RIGHT_ANALOG_BOUNDARY"};
+
+        if (field < KbmFields)
+            return std::string(KbmButtons[field].first);
+        else if (field < firstBackButtonField)
+            return std::string(XinputButtons[field - KbmFields].first);
+
+        if (field < fieldActiveSlots(1)) {
+            const int idx = field - firstBackButtonField;
+            constexpr std::array<std::string_view, 3> suffix = {"", "_START_TIME", "_HOLD_TIME"};
+
+            return std::format("{}_K{}{}", backButtons[idx / (Slots * 3)], (idx / 3) % Slots + 1, suffix[idx % 3]);
+        }
+
+        if (field < fieldRumble())
+            return std::format("{}_ACTIVE_SLOTS", backButtons[field - fieldActiveSlots(1)]);
+        else if (field == fieldRumble())
+            return "RUMBLE";
+        else if (field < fieldLedMode())
+            return std::string(deadZoneNames[field - fieldDeadZone(DeadZoneField::LeftCenter)]);
+        else if (field == fieldLedMode())
+            return "LED_MODE";
+
+        return "LED_COLOR";
+    }
+
+    std::string ConfigImage::fieldToString(const int field) const {
+        if (field < KbmFields)
+            return kbm[field];
+        else if (field < firstBackButtonField)
+            return xinput[field - KbmFields];
+
+        if (field < fieldActiveSlots(1)) {
+            const int idx = field - firstBackButtonField;
+            const int num = idx / (Slots * 3);
+            const int slot = (idx / 3) % Slots;
+
+            switch (static_cast<SlotField>(idx % 3)) {
+                case SlotField::Key:
+                    return backButtonKeys[num][slot];
+                case SlotField::StartTime:
+                    return std::to_string(backButtonStartTimes[num][slot]);
+                case SlotField::HoldTime:
+                    return std::to_string(backButtonHoldTimes[num][slot]);
+            }
+        }
+
+        if (field < fieldRumble())
+            return std::to_string(activeSlots[field - fieldActiveSlots(1)]);
+        else if (field == fieldRumble())
+            return std::to_string(rumble);
+        else if (field < fieldLedMode())
+            return std::to_string(deadZone[field - fieldDeadZone(DeadZoneField::LeftCenter)]);
+        else if (field == fieldLedMode())
+            return std::to_string(ledMode);
+
+        return std::format("{} {} {}", std::get<0>(ledColor), std::get<1>(ledColor), std::get<2>(ledColor));
+    }
+
+    void ConfigImage::hashField(uint32_t &hash, const int field) const {
+        const std::string *str = nullptr;
+        int val = 0;
+
+        if (field < KbmFields) {
+            str = &kbm[field];
+
+        } else if (field < firstBackButtonField) {
+            str = &xinput[field - KbmFields];
+
+        } else if (field < fieldActiveSlots(1)) {
+            const int idx = field - firstBackButtonField;
+            const int num = idx / (Slots * 3);
+            const int slot = (idx / 3) % Slots;
+
+            if (static_cast<SlotField>(idx % 3) == SlotField::Key)
+                str = &backButtonKeys[num][slot];
+            else
+                val = static_cast<SlotField>(idx % 3) == SlotField::StartTime ? backButtonStartTimes[num][slot] : backButtonHoldTimes[num][slot];
+
+        } else if (field < fieldRumble()) {
+            val = activeSlots[field - fieldActiveSlots(1)];
+
+        } else if (field == fieldRumble()) {
+            val = rumble;
+
+        } else if (field < fieldLedMode()) {
+            val = deadZone[field - fieldDeadZone(DeadZoneField::LeftCenter)];
+
+        } else if (field == fieldLedMode()) {
+            val = ledMode;
+
+        } else {
+            const int rgb[3] = {std::get<0>(ledColor), std::get<1>(ledColor), std::get<2>(ledColor)};
+
+            hashBytes(hash, rgb, sizeof(rgb));
+            return;
+        }
+
+        // the terminator keeps "AB" "C" and "A" "BC" apart
+        if (str)
+            hashBytes(hash, str->c_str(), str->size() + 1);
+        else
+            hashBytes(hash, &val, sizeof(val));
+    }
+
+    uint32_t ConfigImage::checksum(const int blocks, const std::bitset<FieldCount> &fields) const {
+        uint32_t hash = 2166136261u;
+
+        for (int i=0; i<FieldCount; ++i) {
+            if (fields.test(i) && (blocks & (1 << static_cast<int>(fieldBlock(i)))))
+                hashField(hash, i);
+        }
+
+        return hash;
+    }
+}
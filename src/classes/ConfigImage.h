@@ -0,0 +1,156 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#include "../extern/libOpenWinControls/src/controller/Controller.h"
+
+namespace OWC {
+    enum struct ConfigBlock: int {
+        KeyboardMouse = 0,
+        Xinput,
+        BackButton1,
+        BackButton2,
+        BackButton3,
+        BackButton4,
+        Rumble,
+        DeadZone,
+        Leds,
+        Count
+    };
+
+    /*
+     * In-memory copy of a controller config, one value per field
+     *
+     * Fields are addressed by a flat index, see the field* helpers.
+     * Only present fields are applied or compared, a capture from a device marks all supported fields present.
+     */
+    class ConfigImage final {
+    public:
+        static constexpr int BackButtons = 4;
+        static constexpr int Slots = 32;
+        static constexpr int KbmFields = 21;
+        static constexpr int XinputFields = 25;
+        static constexpr int BackButtonFields = BackButtons * Slots * 3;
+        static constexpr int FieldCount = KbmFields + XinputFields + BackButtonFields + BackButtons + 1 + 4 + 2;
+
+        enum struct SlotField: int { Key = 0, StartTime, HoldTime };
+        enum struct DeadZoneField: int { LeftCenter = 0, LeftBoundary, RightCenter, RightBoundary };
+
+        static constexpr std::array<std::pair<std::string_view, Button>, KbmFields> KbmButtons = {{
+            {"A", Button::KBD_A},
+            {"B", Button::KBD_B},
+            {"X", Button::KBD_X},
+            {"Y", Button::KBD_Y},
+            {"DPAD_UP", Button::KBD_DPAD_UP},
+            {"DPAD_DOWN", Button::KBD_DPAD_DOWN},
+            {"DPAD_LEFT", Button::KBD_DPAD_LEFT},
+            {"DPAD_RIGHT", Button::KBD_DPAD_RIGHT},
+            {"L_ANALOG_UP", Button::KBD_LANALOG_UP},
+            {"L_ANALOG_DOWN", Button::KBD_LANALOG_DOWN},
+            {"L_ANALOG_LEFT", Button::KBD_LANALOG_LEFT},
+            {"L_ANALOG_RIGHT", Button::KBD_LANALOG_RIGHT},
+            {"L1", Button::KBD_L1},
+            {"L2", Button::KBD_L2},
+            {"L3", Button::KBD_L3},
+            {"R1", Button::KBD_R1},
+            {"R2", Button::KBD_R2},
+            {"R3", Button::KBD_R3},
+            {"START", Button::KBD_START},
+            {"SELECT", Button::KBD_SELECT},
+            {"MENU", Button::KBD_MENU}
+        }};
+
+        static constexpr std::array<std::pair<std::string_view, Button>, XinputFields> XinputButtons = {{
+            {"X_A", Button::X_A},
+            {"X_B", Button::X_B},
+            {"X_X", Button::X_X},
+            {"X_Y", Button::X_Y},
+            {"X_DPAD_UP", Button::X_DPAD_UP},
+            {"X_DPAD_DOWN", Button::X_DPAD_DOWN},
+            {"X_DPAD_LEFT", Button::X_DPAD_LEFT},
+            {"X_DPAD_RIGHT", Button::X_DPAD_RIGHT},
+            {"X_L_ANALOG_UP", Button::X_LANALOG_UP},
+            {"X_L_ANALOG_DOWN", Button::X_LANALOG_DOWN},
+            {"X_L_ANALOG_LEFT", Button::X_LANALOG_LEFT},
+            {"X_L_ANALOG_RIGHT", Button::X_LANALOG_RIGHT},
+            {"X_R_ANALOG_UP", Button::X_RANALOG_UP},
+            {"X_R_ANALOG_DOWN", Button::X_RANALOG_DOWN},
+            {"X_R_ANALOG_LEFT", Button::X_RANALOG_LEFT},
+            {"X_R_ANALOG_RIGHT", Button::X_RANALOG_RIGHT},
+            {"X_L1", Button::X_L1},
+            {"X_L2", Button::X_L2},
+            {"X_L3", Button::X_L3},
+            {"X_R1", Button::X_R1},
+            {"X_R2", Button::X_R2},
+            {"X_R3", Button::X_R3},
+            {"X_START", Button::X_START},
+            {"X_SELECT", Button::X_SELECT},
+            {"X_MENU", Button::X_MENU}
+        }};
+
+        int controllerType = 0;
+        std::array<std::string, KbmFields> kbm;
+        std::array<std::string, XinputFields> xinput;
+        std::array<std::array<std::string, Slots>, BackButtons> backButtonKeys;
+        std::array<std::array<int, Slots>, BackButtons> backButtonStartTimes {};
+        std::array<std::array<int, Slots>, BackButtons> backButtonHoldTimes {};
+        std::array<int, BackButtons> activeSlots {};
+        int rumble = 0;
+        std::array<int, 4> deadZone {};
+        int ledMode = 0;
+        std::tuple<int, int, int> ledColor {};
+        std::bitset<FieldCount> present;
+
+        // num and slot are 1-based, like the controller API
+        [[nodiscard]] static constexpr int fieldKbm(const int idx) { return idx; }
+        [[nodiscard]] static constexpr int fieldXinput(const int idx) { return KbmFields + idx; }
+        [[nodiscard]] static constexpr int fieldBackButton(const int num, const int slot, const SlotField field) { return KbmFields + XinputFields + ((num - 1) * Slots + (slot - 1)) * 3 + static_cast<int>(field); }
+        [[nodiscard]] static constexpr int fieldActiveSlots(const int num) { return KbmFields + XinputFields + BackButtonFields + (num - 1); }
+        [[nodiscard]] static constexpr int fieldRumble() { return fieldActiveSlots(BackButtons) + 1; }
+        [[nodiscard]] static constexpr int fieldDeadZone(const DeadZoneField field) { return fieldRumble() + 1 + static_cast<int>(field); }
+        [[nodiscard]] static constexpr int fieldLedMode() { return fieldDeadZone(DeadZoneField::RightBoundary) + 1; }
+        [[nodiscard]] static constexpr int fieldLedColor() { return fieldLedMode() + 1; }
+        [[nodiscard]] static ConfigBlock fieldBlock(int field);
+        [[nodiscard]] static std::string_view blockToString(ConfigBlock block);
+
+        [[nodiscard]] static ConfigImage capture(const std::shared_ptr<Controller> &gpd);
+        void apply(const std::shared_ptr<Controller> &gpd) const;
+        [[nodiscard]] bool fieldEquals(const ConfigImage &other, int field) const;
+        [[nodiscard]] int diff(const ConfigImage &other) const;
+        // present fields that other lacks or holds a different value for
+        [[nodiscard]] std::bitset<FieldCount> changedFields(const ConfigImage &other) const;
+        [[nodiscard]] std::string serialize() const;
+        [[nodiscard]] static bool deserialize(std::string_view data, ConfigImage &img);
+        // profile key style, L4_K2_START_TIME
+        [[nodiscard]] static std::string fieldName(int field);
+        [[nodiscard]] std::string fieldToString(int field) const;
+        // FNV-1a over the given fields of the blocks in the mask (1 << ConfigBlock)
+        [[nodiscard]] uint32_t checksum(int blocks, const std::bitset<FieldCount> &fields) const;
+
+    private:
+        void hashField(uint32_t &hash, int field) const;
+    };
+}
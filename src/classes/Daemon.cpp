@@ -0,0 +1,445 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#ifdef __linux__
+#include <csignal>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "Daemon.h"
+
+namespace OWC {
+#ifdef __linux__
+    static volatile std::sig_atomic_t stopRequested = 0;
+
+    static void onStopSignal(int) {
+        stopRequested = 1;
+    }
+
+    [[nodiscard]]
+    static int connectSocket(const std::string &path) {
+        sockaddr_un addr {};
+        int fd;
+
+        if (path.size() >= sizeof(addr.sun_path))
+            return -1;
+
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1)
+            return -1;
+
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size());
+
+        if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1) {
+            close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    // the socket path may be claimed by someone else, only talk to our own user
+    [[nodiscard]]
+    static bool isSameUser(const int fd) {
+        ucred cred {};
+        socklen_t len = sizeof(cred);
+
+        return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0 && cred.uid == getuid();
+    }
+#endif
+
+    Daemon::Daemon() {
+        sockPath = getSocketPath();
+    }
+
+    Daemon::~Daemon() {
+#ifdef __linux__
+        if (sockFd == -1)
+            return;
+
+        close(sockFd);
+        unlink(sockPath.c_str());
+#endif
+    }
+
+    std::string Daemon::getSocketPath() {
+        const char *path = std::getenv("OWCD_SOCKET");
+
+        if (path && *path)
+            return path;
+
+#ifdef __linux__
+        const char *runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+
+        if (runtimeDir && *runtimeDir)
+            return std::string(runtimeDir) + "/owcd.sock";
+
+        return "/tmp/owcd-" + std::to_string(getuid()) + ".sock";
+#else
+        return "";
+#endif
+    }
+
+    bool Daemon::sendAll(const int fd, const void *buf, size_t len) {
+#ifdef __linux__
+        const char *p = static_cast<const char *>(buf);
+
+        while (len > 0) {
+            const ssize_t ret = send(fd, p, len, MSG_NOSIGNAL);
+
+            if (ret == -1 && errno == EINTR && !stopRequested)
+                continue;
+            else if (ret <= 0)
+                return false;
+
+            p += ret;
+            len -= ret;
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool Daemon::recvAll(const int fd, void *buf, size_t len) {
+#ifdef __linux__
+        char *p = static_cast<char *>(buf);
+
+        while (len > 0) {
+            const ssize_t ret = recv(fd, p, len, 0);
+
+            if (ret == -1 && errno == EINTR && !stopRequested)
+                continue;
+            else if (ret <= 0)
+                return false;
+
+            p += ret;
+            len -= ret;
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool Daemon::sendString(const int fd, const std::string &str) {
+        const uint32_t len = str.size();
+
+        return sendAll(fd, &len, sizeof(len)) && sendAll(fd, str.data(), str.size());
+    }
+
+    bool Daemon::recvString(const int fd, std::string &str) {
+        uint32_t len;
+
+        if (!recvAll(fd, &len, sizeof(len)) || len > (1 << 20))
+            return false;
+
+        str.resize(len);
+        return recvAll(fd, str.data(), len);
+    }
+
+    bool Daemon::sendCount(const int fd, const uint32_t count) {
+#ifdef __linux__
+        // pass our stdin along, so that commands reading it (batch -) read from the client
+        alignas(cmsghdr) char ctrl[CMSG_SPACE(sizeof(int))] {};
+        iovec iov = {const_cast<uint32_t *>(&count), sizeof(count)};
+        msghdr msg {};
+        cmsghdr *cmsg;
+        ssize_t ret;
+
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = ctrl;
+        msg.msg_controllen = sizeof(ctrl);
+
+        cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        *reinterpret_cast<int *>(CMSG_DATA(cmsg)) = STDIN_FILENO;
+
+        do {
+            ret = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        } while (ret == -1 && errno == EINTR && !stopRequested);
+
+        return ret == sizeof(count);
+#else
+        return false;
+#endif
+    }
+
+    bool Daemon::recvCount(const int fd, uint32_t &count, int &stdinFd) {
+#ifdef __linux__
+        alignas(cmsghdr) char ctrl[CMSG_SPACE(sizeof(int))] {};
+        iovec iov = {&count, sizeof(count)};
+        msghdr msg {};
+        ssize_t ret;
+
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = ctrl;
+        msg.msg_controllen = sizeof(ctrl);
+
+        do {
+            ret = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+        } while (ret == -1 && errno == EINTR && !stopRequested);
+
+        for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+                stdinFd = *reinterpret_cast<int *>(CMSG_DATA(cmsg));
+        }
+
+        return ret == sizeof(count);
+#else
+        return false;
+#endif
+    }
+
+    int Daemon::forward(const std::vector<std::string> &args) {
+#ifdef __linux__
+        const int fd = connectSocket(getSocketPath());
+        std::string out, err;
+        uint32_t count;
+        int32_t ret;
+        char *cwd;
+        bool sent;
+
+        if (fd == -1)
+            return -1;
+
+        // it would get our stdin and working directory
+        if (!isSameUser(fd)) {
+            std::cerr << "daemon socket " << getSocketPath() << " belongs to another user, not forwarding\n";
+            close(fd);
+            return 1;
+        }
+
+        cwd = getcwd(nullptr, 0);
+        count = args.size() + 1;
+        sent = sendCount(fd, count) && sendString(fd, cwd ? cwd : "/");
+
+        std::free(cwd);
+        for (int i=0,l=args.size(); i<l && sent; ++i)
+            sent = sendString(fd, args[i]);
+
+        if (!sent || !recvAll(fd, &ret, sizeof(ret)) || !recvString(fd, out) || !recvString(fd, err)) {
+            std::cerr << "lost connection to daemon\n";
+            close(fd);
+            return 1;
+        }
+
+        close(fd);
+        std::cout << out;
+        std::cerr << err;
+        return ret;
+#else
+        return -1;
+#endif
+    }
+
+    bool Daemon::init() {
+#ifdef __linux__
+        sockaddr_un addr {};
+        struct sigaction sa {};
+        struct stat st {};
+        int fd;
+
+        if (sockPath.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "socket path is too long: " << sockPath << "\n";
+            return false;
+        }
+
+        fd = connectSocket(sockPath);
+        if (fd != -1) {
+            std::cerr << "daemon is already running on " << sockPath << "\n";
+            close(fd);
+            return false;
+        }
+
+        // stale socket from a previous instance, never remove anything else
+        if (lstat(sockPath.c_str(), &st) == 0) {
+            if (!S_ISSOCK(st.st_mode) || st.st_uid != getuid()) {
+                std::cerr << sockPath << " exists and is not a socket of ours, not replacing it\n";
+                return false;
+            }
+
+            unlink(sockPath.c_str());
+        }
+
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd == -1) {
+            std::cerr << "failed to create socket: " << std::strerror(errno) << "\n";
+            return false;
+        }
+
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, sockPath.c_str(), sockPath.size());
+
+        if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1 || chmod(sockPath.c_str(), S_IRUSR | S_IWUSR) == -1 || listen(fd, 8) == -1) {
+            std::cerr << "failed to listen on " << sockPath << ": " << std::strerror(errno) << "\n";
+            close(fd);
+            unlink(sockPath.c_str());
+            return false;
+        }
+
+        // no SA_RESTART, accept() and client reads must return on signal
+        sa.sa_handler = onStopSignal;
+        sigaction(SIGINT, &sa, nullptr);
+        sigaction(SIGTERM, &sa, nullptr);
+
+        sockFd = fd;
+        return true;
+#else
+        std::cerr << "daemon mode is not supported on this platform\n";
+        return false;
+#endif
+    }
+
+    void Daemon::closeFd(const int fd) {
+#ifdef __linux__
+        if (fd != -1)
+            close(fd);
+#endif
+    }
+
+    int Daemon::redirectStdin(const int fd) {
+#ifdef __linux__
+        int saved;
+
+        if (fd == -1)
+            return -1;
+
+        saved = dup(STDIN_FILENO);
+        dup2(fd, STDIN_FILENO);
+        close(fd);
+        clearerr(stdin);
+        std::cin.clear();
+
+        return saved;
+#else
+        return -1;
+#endif
+    }
+
+    void Daemon::serveClient(const int fd, const std::function<int(const CMDParser &)> &handler) const {
+        std::ostringstream out, err;
+        std::vector<std::string> args;
+        std::vector<char *> argv;
+        int stdinFd = -1;
+        uint32_t count;
+        int32_t ret = 1;
+
+        if (!recvCount(fd, count, stdinFd) || count < 1 || count > 4096) {
+            closeFd(stdinFd);
+            return;
+        }
+
+        args.resize(count);
+        for (std::string &arg: args) {
+            if (!recvString(fd, arg)) {
+                closeFd(stdinFd);
+                return;
+            }
+        }
+
+#ifdef __linux__
+        // relative paths in import/export are relative to the client
+        if (chdir(args[0].c_str()) == -1) {
+            err << "failed to change directory to " << args[0] << "\n";
+            args.resize(1);
+        }
+#endif
+
+        // args[0] takes the place of the program name
+        for (std::string &arg: args)
+            argv.push_back(arg.data());
+
+        if (argv.size() > 1) {
+            const int savedStdin = redirectStdin(stdinFd);
+            std::streambuf *coutBuf = std::cout.rdbuf(out.rdbuf());
+            std::streambuf *cerrBuf = std::cerr.rdbuf(err.rdbuf());
+            CMDParser cmd (argv.size(), argv.data());
+
+            if (!cmd.parse())
+                ret = 1;
+            else if (cmd.hasArg("daemon"))
+                std::cerr << "daemon is already running\n";
+            else if (cmd.hasArg("watch") || cmd.hasArg("autoswitch"))
+                std::cerr << "watch and autoswitch cannot run while the daemon holds the controller, stop the daemon first\n";
+            else
+                ret = handler(cmd);
+
+            std::cout.rdbuf(coutBuf);
+            std::cerr.rdbuf(cerrBuf);
+            redirectStdin(savedStdin);
+
+        } else {
+            closeFd(stdinFd);
+        }
+
+        if (!sendAll(fd, &ret, sizeof(ret)) || !sendString(fd, out.str()) || !sendString(fd, err.str()))
+            std::cerr << "failed to send response to client\n";
+    }
+
+    int Daemon::run(const std::function<int(const CMDParser &)> &handler) const {
+#ifdef __linux__
+        std::cout << "listening on " << sockPath << "\n";
+
+        while (!stopRequested) {
+            const int fd = accept4(sockFd, nullptr, nullptr, SOCK_CLOEXEC);
+
+            if (fd == -1) {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+
+                std::cerr << "accept failed: " << std::strerror(errno) << "\n";
+                return 1;
+            }
+
+            if (isSameUser(fd)) {
+                const timeval tv {ClientTimeoutMs / 1000, (ClientTimeoutMs % 1000) * 1000};
+
+                setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+                setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+                serveClient(fd, handler);
+
+            } else {
+                std::cerr << "refused a client of another user\n";
+            }
+
+            close(fd);
+        }
+
+        return 0;
+#else
+        return 1;
+#endif
+    }
+}
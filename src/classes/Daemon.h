@@ -0,0 +1,63 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <functional>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CMDParser.h"
+
+namespace OWC {
+    /*
+     * owcd, keeps the controller open and serves commands from other CLI instances over a unix socket
+     *
+     * request:  u32 count (carries the client stdin fd), count * (u32 len, bytes), first string is the client working directory
+     * response: i32 exit code, u32 len, stdout bytes, u32 len, stderr bytes
+     */
+    class Daemon final {
+    private:
+        // a client that stalls mid request is dropped after this, the others are served one at a time behind it
+        static constexpr int ClientTimeoutMs = 5000;
+
+        std::string sockPath;
+        int sockFd = -1;
+
+        [[nodiscard]] static bool sendAll(int fd, const void *buf, size_t len);
+        [[nodiscard]] static bool recvAll(int fd, void *buf, size_t len);
+        [[nodiscard]] static bool sendString(int fd, const std::string &str);
+        [[nodiscard]] static bool recvString(int fd, std::string &str);
+        [[nodiscard]] static bool sendCount(int fd, uint32_t count);
+        [[nodiscard]] static bool recvCount(int fd, uint32_t &count, int &stdinFd);
+        static void closeFd(int fd);
+        static int redirectStdin(int fd);
+        void serveClient(int fd, const std::function<int(const CMDParser &)> &handler) const;
+
+    public:
+        Daemon();
+        Daemon(Daemon &) = delete;
+
+        ~Daemon();
+
+        [[nodiscard]] static std::string getSocketPath();
+        [[nodiscard]] static int forward(const std::vector<std::string> &args);
+        [[nodiscard]] bool init();
+        [[nodiscard]] int run(const std::function<int(const CMDParser &)> &handler) const;
+    };
+}
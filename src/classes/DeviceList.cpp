@@ -0,0 +1,122 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <format>
+
+#include "DeviceList.h"
+
+namespace OWC {
+    bool DeviceList::readUevent(const std::filesystem::path &file, DeviceInfo &info, int &vendorId) {
+        std::ifstream ifs (file);
+        std::string line;
+        bool hasId = false;
+
+        if (!ifs.is_open())
+            return false;
+
+        while (std::getline(ifs, line)) {
+            unsigned bus, vid, pid;
+
+            if (line.starts_with("HID_ID=") && std::sscanf(line.c_str() + 7, "%x:%x:%x", &bus, &vid, &pid) == 3) {
+                vendorId = vid;
+                info.productId = pid;
+                hasId = true;
+
+            } else if (line.starts_with("HID_NAME=")) {
+                info.name = line.substr(9);
+
+            } else if (line.starts_with("HID_UNIQ=")) {
+                info.serial = line.substr(9);
+
+            } else if (line.starts_with("HID_PHYS=")) {
+                info.phys = line.substr(9);
+            }
+        }
+
+        // usb-0000:00:14.0-9/input2 -> usb-0000:00:14.0-9
+        info.phys = info.phys.substr(0, info.phys.rfind("/input"));
+        return hasId;
+    }
+
+    std::vector<DeviceInfo> DeviceList::enumerate() {
+        std::vector<DeviceInfo> devices;
+#ifdef __linux__
+        std::vector<std::filesystem::path> nodes;
+        std::error_code ec;
+
+        for (const std::filesystem::directory_entry &entry: std::filesystem::directory_iterator("/sys/class/hidraw", ec))
+            nodes.push_back(entry.path());
+
+        // hidraw2 before hidraw10
+        std::ranges::sort(nodes, [](const std::filesystem::path &a, const std::filesystem::path &b) {
+            const std::string na = a.filename().string();
+            const std::string nb = b.filename().string();
+
+            return na.size() != nb.size() ? na.size() < nb.size() : na < nb;
+        });
+
+        for (const std::filesystem::path &node: nodes) {
+            const std::string devNode = "/dev/" + node.filename().string();
+            DeviceInfo info;
+            int vendorId = 0;
+            std::vector<DeviceInfo>::iterator it;
+
+            if (!readUevent(node / "device/uevent", info, vendorId) || vendorId != VendorId)
+                continue;
+
+            it = std::ranges::find_if(devices, [&info](const DeviceInfo &dev) {
+                return dev.productId == info.productId && (info.phys.empty() ? dev.serial == info.serial : dev.phys == info.phys);
+            });
+
+            if (it == devices.end()) {
+                info.nodes.push_back(devNode);
+                devices.push_back(std::move(info));
+
+            } else {
+                it->nodes.push_back(devNode);
+            }
+        }
+#endif
+        return devices;
+    }
+
+    void DeviceList::print() {
+        const std::vector<DeviceInfo> devices = enumerate();
+        std::string out;
+
+        if (devices.empty()) {
+            std::cout << "no controllers found\n";
+            return;
+        }
+
+        for (const DeviceInfo &dev: devices) {
+            std::string nodes;
+
+            for (const std::string &node: dev.nodes)
+                nodes += nodes.empty() ? node : "," + node;
+
+            std::format_to(std::back_inserter(out), "{}\t{:04x}:{:04x}\tserial: {}\tport: {}\t{}\n", nodes, VendorId, dev.productId,
+                dev.serial.empty() ? "-" : dev.serial, dev.phys.empty() ? "-" : dev.phys, dev.name);
+        }
+
+        std::cout << out;
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace OWC {
+    struct DeviceInfo final {
+        std::vector<std::string> nodes; // one hidraw node per HID interface
+        std::string name;
+        std::string serial;
+        std::string phys; // usb port path, interfaces of the same controller share it
+        int productId = 0;
+    };
+
+    /*
+     * GPD controllers attached to the system, from sysfs hidraw nodes
+     *
+     * Only used for listing, the controller library opens the first VID/PID match on its own.
+     */
+    class DeviceList final {
+    private:
+        static constexpr int VendorId = 0x2f24;
+
+        [[nodiscard]] static bool readUevent(const std::filesystem::path &file, DeviceInfo &info, int &vendorId);
+
+    public:
+        DeviceList() = delete;
+
+        [[nodiscard]] static std::vector<DeviceInfo> enumerate();
+        static void print();
+    };
+}
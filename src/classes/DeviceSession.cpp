@@ -0,0 +1,309 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+
+#include "DeviceSession.h"
+#include "../extern/libOpenWinControls/src/controller/ControllerV1.h"
+#include "../extern/libOpenWinControls/src/controller/ControllerV2.h"
+
+namespace OWC {
+    template <typename T>
+    static void appendInt(std::string &out, const T val) {
+        out.append(reinterpret_cast<const char *>(&val), sizeof(val));
+    }
+
+    template <typename T>
+    [[nodiscard]]
+    static bool readInt(std::string_view &in, T &val) {
+        if (in.size() < sizeof(val))
+            return false;
+
+        std::memcpy(&val, in.data(), sizeof(val));
+        in.remove_prefix(sizeof(val));
+        return true;
+    }
+
+    DeviceSession *DeviceSession::getInstance() {
+        if (!instance)
+            instance = new DeviceSession();
+
+        return instance;
+    }
+
+    std::string_view DeviceSession::opToString(const Op op) {
+        switch (op) {
+            case Op::Init:
+                return "init";
+            case Op::ReadVersion:
+                return "readVersion";
+            case Op::ReadConfig:
+                return "readConfig";
+            case Op::WriteConfig:
+                return "writeConfig";
+            case Op::ResetConfig:
+                return "resetConfig";
+            default:
+                return "unknown";
+        }
+    }
+
+    bool DeviceSession::runOp(const std::shared_ptr<Controller> &gpd, const Op op) {
+        switch (op) {
+            case Op::Init:
+                return gpd->init();
+            case Op::ReadVersion:
+                return gpd->readVersion();
+            case Op::ReadConfig:
+                return gpd->readConfig();
+            case Op::WriteConfig:
+                return gpd->writeConfig();
+            case Op::ResetConfig:
+                return gpd->resetConfig();
+            default:
+                return false;
+        }
+    }
+
+    void DeviceSession::captureState(const std::shared_ptr<Controller> &gpd, const Op op) {
+        const std::shared_ptr<ControllerV1> gpdV1 = std::dynamic_pointer_cast<ControllerV1>(gpd);
+        const std::shared_ptr<ControllerV2> gpdV2 = std::dynamic_pointer_cast<ControllerV2>(gpd);
+
+        if (op == Op::ReadVersion && gpdV1) {
+            state.xVersion = gpdV1->getXVersion();
+            state.kVersion = gpdV1->getKVersion();
+
+        } else if (op == Op::ReadVersion && gpdV2) {
+            state.version = gpdV2->getVersion();
+
+        } else if (op == Op::ReadConfig && gpdV2) {
+            state.emulationMode = static_cast<int>(gpdV2->getEmulationMode());
+
+            for (int i=0; i<ConfigImage::BackButtons; ++i)
+                state.backButtonModes[i] = static_cast<int>(gpdV2->getBackButtonMode(i + 1));
+        }
+    }
+
+    std::string DeviceSession::encodePayload(const std::shared_ptr<Controller> &gpd, const Op op) const {
+        std::string out;
+
+        if (op == Op::ReadVersion) {
+            for (const std::pair<int, int> &ver: {state.xVersion, state.kVersion, state.version}) {
+                appendInt<int32_t>(out, ver.first);
+                appendInt<int32_t>(out, ver.second);
+            }
+
+        } else if (op == Op::ReadConfig || op == Op::WriteConfig) {
+            if (op == Op::ReadConfig) {
+                appendInt<int32_t>(out, state.emulationMode);
+
+                for (const int btnMode: state.backButtonModes)
+                    appendInt<int32_t>(out, btnMode);
+            }
+
+            // what the controller returned or was sent
+            out += ConfigImage::capture(gpd).serialize();
+        }
+
+        return out;
+    }
+
+    bool DeviceSession::decodePayload(const std::shared_ptr<Controller> &gpd, const Transaction &tr) {
+        std::string_view data = tr.payload;
+        DeviceState tmp = state;
+        ConfigImage img;
+        bool ok = true;
+
+        if (tr.op == Op::ReadVersion) {
+            for (std::pair<int, int> *ver: {&tmp.xVersion, &tmp.kVersion, &tmp.version})
+                ok = ok && readInt(data, ver->first) && readInt(data, ver->second);
+
+        } else if (tr.op == Op::ReadConfig) {
+            ok = readInt(data, tmp.emulationMode);
+
+            for (int &btnMode: tmp.backButtonModes)
+                ok = ok && readInt(data, btnMode);
+
+            ok = ok && ConfigImage::deserialize(data, img);
+            if (ok)
+                img.apply(gpd);
+
+        } else if (tr.op == Op::WriteConfig) {
+            ok = ConfigImage::deserialize(data, img);
+
+            // the recording still answers, but the output may no longer match the recorded session
+            if (ok && ConfigImage::capture(gpd).diff(img) != 0)
+                std::cerr << "replay diverged: the written config differs from the recording\n";
+        }
+
+        if (!ok) {
+            std::cerr << "replay: corrupt " << opToString(tr.op) << " transaction in " << fileName << "\n";
+            return false;
+        }
+
+        state = tmp;
+        return true;
+    }
+
+    bool DeviceSession::load() {
+        std::ifstream ifs (fileName, std::ios::binary);
+        std::stringstream buf;
+        std::string_view data;
+        uint32_t count = 0;
+        uint8_t version = 0;
+        uint8_t len = 0;
+
+        if (!ifs.is_open()) {
+            std::cerr << "failed to open " << fileName << "\n";
+            return false;
+        }
+
+        buf << ifs.rdbuf();
+        data = buf.view();
+
+        if (!data.starts_with(Magic) || (data.remove_prefix(sizeof(Magic) - 1), !readInt(data, version)) || version != FormatVersion) {
+            std::cerr << fileName << " is not a recording or was made by a different version\n";
+            return false;
+        }
+
+        if (!readInt(data, len) || data.size() < len) {
+            std::cerr << "corrupt recording " << fileName << "\n";
+            return false;
+        }
+
+        product = data.substr(0, len);
+        data.remove_prefix(len);
+
+        if (!readInt(data, count)) {
+            std::cerr << "corrupt recording " << fileName << "\n";
+            return false;
+        }
+
+        transactions.reserve(std::min<uint32_t>(count, 4096));
+
+        for (uint32_t i=0; i<count; ++i) {
+            Transaction tr;
+            uint8_t op, ok;
+            uint32_t payloadLen;
+
+            if (!readInt(data, op) || !readInt(data, ok) || !readInt(data, tr.start) || !readInt(data, tr.dur) ||
+                !readInt(data, payloadLen) || data.size() < payloadLen || op > static_cast<uint8_t>(Op::ResetConfig)) {
+                std::cerr << "corrupt recording " << fileName << "\n";
+                return false;
+            }
+
+            tr.op = static_cast<Op>(op);
+            tr.ok = ok != 0;
+            tr.payload = data.substr(0, payloadLen);
+            data.remove_prefix(payloadLen);
+            transactions.push_back(std::move(tr));
+        }
+
+        return true;
+    }
+
+    bool DeviceSession::init(const Mode mode, const std::string &fileName, const bool realTime) {
+        this->mode = mode;
+        this->fileName = fileName;
+        this->realTime = realTime;
+
+        return mode != Mode::Replay || load();
+    }
+
+    bool DeviceSession::call(const std::shared_ptr<Controller> &gpd, const Op op) {
+        if (mode == Mode::Replay) {
+            if (next >= transactions.size()) {
+                std::cerr << "replay diverged: " << opToString(op) << " called after the end of the recording\n";
+                return false;
+            }
+
+            const Transaction &tr = transactions[next++];
+
+            if (tr.op != op) {
+                std::cerr << "replay diverged: " << opToString(op) << " called, the recording has " << opToString(tr.op) << "\n";
+                return false;
+            }
+
+            // the recorded gap since the session start, then the call itself
+            if (realTime) {
+                std::this_thread::sleep_until(origin + std::chrono::nanoseconds(tr.start));
+                std::this_thread::sleep_for(std::chrono::nanoseconds(tr.dur));
+            }
+
+            return tr.ok && decodePayload(gpd, tr);
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const bool ok = runOp(gpd, op);
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        if (ok)
+            captureState(gpd, op);
+
+        if (mode == Mode::Record) {
+            transactions.push_back({
+                .op = op,
+                .ok = ok,
+                .start = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin).count(),
+                .dur = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+                .payload = ok ? encodePayload(gpd, op) : ""
+            });
+        }
+
+        return ok;
+    }
+
+    bool DeviceSession::finish() {
+        std::ofstream ofs;
+        std::string out;
+
+        if (mode != Mode::Record)
+            return true;
+
+        out.append(Magic, sizeof(Magic) - 1);
+        appendInt<uint8_t>(out, FormatVersion);
+        appendInt<uint8_t>(out, std::min<size_t>(product.size(), 255));
+        out.append(product, 0, 255);
+        appendInt<uint32_t>(out, transactions.size());
+
+        for (const Transaction &tr: transactions) {
+            appendInt<uint8_t>(out, static_cast<uint8_t>(tr.op));
+            appendInt<uint8_t>(out, tr.ok);
+            appendInt<int64_t>(out, tr.start);
+            appendInt<int64_t>(out, tr.dur);
+            appendInt<uint32_t>(out, tr.payload.size());
+            out += tr.payload;
+        }
+
+        transactions.clear();
+        ofs.open(fileName, std::ios::binary | std::ios::trunc);
+        ofs << out;
+        ofs.close();
+
+        if (ofs.fail()) {
+            std::cerr << "failed to write recording " << fileName << "\n";
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ConfigImage.h"
+
+namespace OWC {
+    // controller state the CLI shows that is not part of the config image
+    struct DeviceState final {
+        std::pair<int, int> xVersion {}; // V1
+        std::pair<int, int> kVersion {}; // V1
+        std::pair<int, int> version {}; // V2
+        int emulationMode = 0; // V2
+        std::array<int, ConfigImage::BackButtons> backButtonModes {}; // V2
+    };
+
+    /*
+     * Every controller transaction goes through here, so that it can be recorded (--record) or served from a recording (--replay)
+     *
+     * The library does not expose its HID reports, a transaction is one library call: init, readVersion, readConfig, writeConfig or resetConfig.
+     * A recording holds the board name and, per call, the result, timestamp, duration and what the call left in (or sent from) the controller.
+     *
+     * file:  "OWCT", u8 format version, u8 len + board name, u32 count, count * transaction
+     * transaction: u8 op, u8 ok, i64 start (ns since the session start), i64 duration (ns), u32 len + payload
+     */
+    class DeviceSession final {
+    public:
+        enum struct Mode: int {
+            Live = 0,
+            Record,
+            Replay
+        };
+
+    private:
+        enum struct Op: uint8_t {
+            Init = 0,
+            ReadVersion,
+            ReadConfig,
+            WriteConfig,
+            ResetConfig
+        };
+
+        struct Transaction final {
+            Op op;
+            bool ok;
+            int64_t start;
+            int64_t dur;
+            std::string payload;
+        };
+
+        static constexpr char Magic[] = "OWCT";
+        static constexpr uint8_t FormatVersion = 1;
+        static inline DeviceSession *instance = nullptr;
+        const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+        std::vector<Transaction> transactions;
+        std::string fileName;
+        std::string product;
+        DeviceState state;
+        Mode mode = Mode::Live;
+        size_t next = 0;
+        bool realTime = false;
+
+        DeviceSession() = default;
+
+        [[nodiscard]] static std::string_view opToString(Op op);
+        [[nodiscard]] static bool runOp(const std::shared_ptr<Controller> &gpd, Op op);
+        void captureState(const std::shared_ptr<Controller> &gpd, Op op);
+        [[nodiscard]] std::string encodePayload(const std::shared_ptr<Controller> &gpd, Op op) const;
+        [[nodiscard]] bool decodePayload(const std::shared_ptr<Controller> &gpd, const Transaction &tr);
+        [[nodiscard]] bool load();
+        [[nodiscard]] bool call(const std::shared_ptr<Controller> &gpd, Op op);
+
+    public:
+        DeviceSession(DeviceSession &) = delete;
+
+        static DeviceSession *getInstance();
+        // replay loads the recording here, realTime starts each call when it was recorded and waits as long as it took
+        [[nodiscard]] bool init(Mode mode, const std::string &fileName, bool realTime = false);
+        [[nodiscard]] Mode getMode() const { return mode; }
+        // the recorded board when replaying
+        [[nodiscard]] const std::string &getProduct() const { return product; }
+        void setProduct(const std::string &name) { product = name; }
+        [[nodiscard]] const DeviceState &getState() const { return state; }
+        [[nodiscard]] bool initDevice(const std::shared_ptr<Controller> &gpd) { return call(gpd, Op::Init); }
+        [[nodiscard]] bool readVersion(const std::shared_ptr<Controller> &gpd) { return call(gpd, Op::ReadVersion); }
+        [[nodiscard]] bool readConfig(const std::shared_ptr<Controller> &gpd) { return call(gpd, Op::ReadConfig); }
+        [[nodiscard]] bool writeConfig(const std::shared_ptr<Controller> &gpd) { return call(gpd, Op::WriteConfig); }
+        [[nodiscard]] bool resetConfig(const std::shared_ptr<Controller> &gpd) { return call(gpd, Op::ResetConfig); }
+        // writes the recording
+        [[nodiscard]] bool finish();
+    };
+}
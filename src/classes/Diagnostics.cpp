@@ -0,0 +1,58 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+
+#include "Diagnostics.h"
+
+namespace OWC {
+    Diagnostics::Diagnostics(const bool collect, const bool pedantic): collect(collect), pedantic(pedantic) {}
+
+    Diagnostics &Diagnostics::console() {
+        // stateless, safe to share
+        static Diagnostics sink;
+
+        return sink;
+    }
+
+    void Diagnostics::error(std::string msg) {
+        if (collect)
+            errors.push_back(std::move(msg));
+        else
+            std::cerr << msg << "\n";
+    }
+
+    void Diagnostics::warning(std::string msg) {
+        if (collect)
+            warnings.push_back(std::move(msg));
+        else
+            std::cerr << msg << "\n";
+    }
+
+    void Diagnostics::info(const std::string &msg) const {
+        if (!collect)
+            std::cout << msg << "\n";
+    }
+
+    void Diagnostics::merge(const Diagnostics &other) {
+        for (const std::string &msg: other.errors)
+            error(msg);
+
+        for (const std::string &msg: other.warnings)
+            warning(msg);
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace OWC {
+    /*
+     * Messages from profile readers and writers, and from the device calls shared with libowccli
+     *
+     * The console sink prints them as they come, like the rest of the CLI does.
+     * A collecting sink keeps them per file, for validate and directory convert running on worker threads,
+     * and per call for the C API, which must not write to the host streams.
+     */
+    class Diagnostics final {
+    private:
+        std::vector<std::string> errors;
+        std::vector<std::string> warnings;
+        bool collect = false;
+        bool pedantic = false;
+
+    public:
+        Diagnostics() = default;
+        Diagnostics(bool collect, bool pedantic);
+
+        [[nodiscard]] static Diagnostics &console();
+        void error(std::string msg);
+        void warning(std::string msg);
+        // progress on stdout, collecting sinks drop it
+        void info(const std::string &msg) const;
+        // pass on what a collecting sink gathered, errors first
+        void merge(const Diagnostics &other);
+        // report what import silently tolerates, keys for the other controller type and clamped values
+        [[nodiscard]] bool isPedantic() const { return pedantic; }
+        [[nodiscard]] const std::vector<std::string> &getErrors() const { return errors; }
+        [[nodiscard]] const std::vector<std::string> &getWarnings() const { return warnings; }
+    };
+}
@@ -16,14 +16,58 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <string_view>
 
 #include "FileLogger.h"
 #include "../version.h"
 
 namespace OWC {
+    // wchar_t is UTF-32 on Linux and UTF-16 on Windows
+    static void appendUtf8(std::string &out, const std::wstring_view str) {
+        for (size_t i=0,l=str.size(); i<l; ++i) {
+            uint32_t cp = static_cast<uint32_t>(str[i]);
+
+            if (sizeof(wchar_t) == 2 && cp >= 0xd800 && cp < 0xdc00 && i + 1 < l && str[i + 1] >= 0xdc00 && str[i + 1] < 0xe000)
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (static_cast<uint32_t>(str[++i]) - 0xdc00);
+
+            if (cp < 0x80) {
+                out += static_cast<char>(cp);
+
+            } else if (cp < 0x800) {
+                out += static_cast<char>(0xc0 | (cp >> 6));
+                out += static_cast<char>(0x80 | (cp & 0x3f));
+
+            } else if (cp < 0x10000) {
+                out += static_cast<char>(0xe0 | (cp >> 12));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (cp & 0x3f));
+
+            } else {
+                out += static_cast<char>(0xf0 | (cp >> 18));
+                out += static_cast<char>(0x80 | ((cp >> 12) & 0x3f));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (cp & 0x3f));
+            }
+        }
+    }
+
+    [[nodiscard]]
+    static std::FILE *openLog(const std::filesystem::path &path, const bool append) {
+#ifdef _WIN32
+        return _wfopen(path.c_str(), append ? L"ab" : L"wb");
+#else
+        return std::fopen(path.c_str(), append ? "ab" : "wb");
+#endif
+    }
+
     FileLogger::~FileLogger() {
-        logF.close();
-        delete instance;
+        stop();
+
+        if (logF)
+            std::fclose(logF);
     }
 
     FileLogger *FileLogger::getInstance() {
@@ -33,32 +77,202 @@ namespace OWC {
         return instance;
     }
 
+    std::filesystem::path FileLogger::getDefaultPath() {
+#ifdef _WIN32
+        const char *localAppData = std::getenv("LOCALAPPDATA");
+
+        if (localAppData && *localAppData)
+            return std::filesystem::path(localAppData) / APP_NAME / "openwincontrols.log";
+#else
+        const char *xdgState = std::getenv("XDG_STATE_HOME");
+        const char *home = std::getenv("HOME");
+
+        if (xdgState && *xdgState)
+            return std::filesystem::path(xdgState) / APP_NAME / "openwincontrols.log";
+        else if (home && *home)
+            return std::filesystem::path(home) / ".local/state" / APP_NAME / "openwincontrols.log";
+#endif
+
+        return "openwincontrols.log";
+    }
+
+    LogLevel FileLogger::getEnvLevel() {
+        static constexpr std::string_view names[] = {"error", "warning", "info", "debug"};
+        const char *env = std::getenv("OWC_LOG_LEVEL");
+
+        if (!env || !*env)
+            return LogLevel::Debug;
+
+        for (int i=0; i<4; ++i) {
+            if (names[i] == env)
+                return static_cast<LogLevel>(i);
+        }
+
+        return LogLevel::Off;
+    }
+
     bool FileLogger::init() {
-        const std::chrono::time_point now = std::chrono::system_clock::now();
-        const std::time_t time = std::chrono::system_clock::to_time_t(now);
+        const std::time_t time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        const char *envPath = std::getenv("OWC_LOG_FILE");
+        std::error_code ec;
 
-        logF.open("openwincontrols.log");
+        // already running, libowccli inits again on every owc_open
+        if (writer.joinable())
+            return true;
 
-        if (!logF.is_open())
+        level = getEnvLevel();
+        if (level == LogLevel::Off)
+            return true;
+
+        logPath = envPath && *envPath ? std::filesystem::path(envPath) : getDefaultPath();
+        if (logPath.has_parent_path())
+            std::filesystem::create_directories(logPath.parent_path(), ec);
+
+        logF = openLog(logPath, true);
+        if (!logF)
             return false;
 
-        logF << APP_NAME " logs - " << std::ctime(&time) << "\n";
+        std::fseek(logF, 0, SEEK_END);
+        logSize = std::ftell(logF);
+
+        ring = std::make_unique<Slot[]>(Capacity);
+        for (size_t i=0; i<Capacity; ++i)
+            ring[i].seq.store(i, std::memory_order_relaxed);
+
+        logSize += std::fprintf(logF, "%s logs - %s\n", APP_NAME, std::ctime(&time));
+        std::fflush(logF);
+        open.store(true, std::memory_order_relaxed);
+
+        writer = std::thread(&FileLogger::run, this);
+
+        // the instance is never deleted, flush what is queued on exit
+        std::atexit([] { instance->stop(); });
         return true;
     }
 
-    void FileLogger::write(const std::wstring &msg, const std::source_location loc) {
-        if (!logF.is_open())
+    void FileLogger::push(const std::wstring &msg, const std::source_location *loc) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Slot *slot;
+
+        while (true) {
+            slot = &ring[pos & (Capacity - 1)];
+
+            const intptr_t diff = static_cast<intptr_t>(slot->seq.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+
+            if (diff == 0 && tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+
+            } else if (diff < 0) {
+                // full, the caller must not wait on the disk
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+
+            } else if (diff > 0) {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->msg = msg;
+        slot->hasLoc = loc != nullptr;
+        if (loc)
+            slot->loc = *loc;
+
+        // seq_cst, pairs with the idle check in run()
+        slot->seq.store(pos + 1);
+
+        if (idle.exchange(false))
+            idle.notify_one();
+    }
+
+    bool FileLogger::empty() const {
+        return ring[head & (Capacity - 1)].seq.load() != head + 1;
+    }
+
+    void FileLogger::rotate() {
+        std::filesystem::path old = logPath;
+        std::error_code ec;
+
+        old += ".1";
+        std::fclose(logF);
+        std::filesystem::rename(logPath, old, ec);
+
+        logF = openLog(logPath, false);
+        logSize = 0;
+
+        // stop queueing messages nobody will write
+        if (!logF)
+            open.store(false, std::memory_order_relaxed);
+    }
+
+    void FileLogger::drain() {
+        const size_t lost = dropped.exchange(0, std::memory_order_relaxed);
+        std::string out;
+
+        while (!empty()) {
+            Slot &slot = ring[head & (Capacity - 1)];
+
+            if (slot.hasLoc)
+                std::format_to(std::back_inserter(out), "{}\n[{}:{}]\n", slot.loc.file_name(), slot.loc.function_name(), slot.loc.line());
+
+            appendUtf8(out, slot.msg);
+            out += "\n\n";
+            slot.msg.clear();
+
+            slot.seq.store(head + Capacity, std::memory_order_release);
+            ++head;
+        }
+
+        if (lost > 0)
+            std::format_to(std::back_inserter(out), "log buffer full, {} messages dropped\n\n", lost);
+
+        if (out.empty() || !logF)
             return;
 
-        logF << loc.file_name() << "\n[" << loc.function_name() << ":" << loc.line() << "]\n" << msg << "\n\n";
-        logF.flush();
+        if (logSize + static_cast<long>(out.size()) > MaxSize) {
+            rotate();
+
+            if (!logF)
+                return;
+        }
+
+        logSize += std::fwrite(out.data(), 1, out.size(), logF);
+        std::fflush(logF);
     }
 
-    void FileLogger::writeExt(const std::wstring &msg) {
-        if (!logF.is_open())
+    void FileLogger::run() {
+        while (!stopRequested) {
+            drain();
+
+            // sleep until push() or stop() clears idle, re-check after announcing so no wakeup is lost
+            idle.store(true);
+            if (!empty() || stopRequested) {
+                idle.store(false);
+                continue;
+            }
+
+            idle.wait(true);
+        }
+
+        drain();
+    }
+
+    void FileLogger::stop() {
+        if (!writer.joinable())
             return;
 
-        logF << msg << "\n\n";
-        logF.flush();
+        stopRequested = true;
+        idle.store(false);
+        idle.notify_one();
+        writer.join();
+    }
+
+    void FileLogger::write(const std::wstring &msg, const LogLevel lvl, const std::source_location loc) {
+        if (isEnabled(lvl))
+            push(msg, &loc);
+    }
+
+    void FileLogger::writeExt(const std::wstring &msg) {
+        if (isEnabled(LogLevel::Debug))
+            push(msg, nullptr);
     }
 }
@@ -17,17 +17,71 @@
  */
 #pragma once
 
-#include <fstream>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
 #include <source_location>
+#include <string>
+#include <thread>
+
+// levels above this are compiled out, 3 keeps controller (HID) messages
+#ifndef OWC_LOG_MAX_LEVEL
+#define OWC_LOG_MAX_LEVEL 3
+#endif
 
 namespace OWC {
+    enum struct LogLevel: int {
+        Error = 0,
+        Warning,
+        Info,
+        Debug, // controller library messages
+        Off = -1
+    };
+
+    /*
+     * Log file, written by a background thread
+     *
+     * Messages go through a bounded lock-free ring (Vyukov MPMC, one consumer) and are written in batches,
+     * so logging never waits on disk in the device I/O path. When the ring is full the message is dropped and counted.
+     * Path and level come from $OWC_LOG_FILE and $OWC_LOG_LEVEL, the file is rotated to .1 at MaxSize.
+     */
     class FileLogger final {
     private:
+        struct Slot final {
+            std::atomic_size_t seq;
+            std::wstring msg;
+            std::source_location loc;
+            bool hasLoc;
+        };
+
+        static constexpr size_t Capacity = 1024; // power of 2
+        static constexpr long MaxSize = 1 << 20;
         static inline FileLogger *instance = nullptr;
-        std::wofstream logF;
+        std::unique_ptr<Slot[]> ring;
+        std::atomic_size_t tail = 0;
+        std::atomic_size_t dropped = 0;
+        std::atomic_bool idle = false;
+        std::atomic_bool stopRequested = false;
+        std::atomic_bool open = false; // logF is usable, callers check this instead of logF
+        size_t head = 0; // writer thread only
+        std::filesystem::path logPath;
+        std::FILE *logF = nullptr; // writer thread only once it runs
+        long logSize = 0;
+        LogLevel level = LogLevel::Debug;
+        std::thread writer;
 
         FileLogger() = default;
 
+        [[nodiscard]] static std::filesystem::path getDefaultPath();
+        [[nodiscard]] static LogLevel getEnvLevel();
+        void push(const std::wstring &msg, const std::source_location *loc);
+        [[nodiscard]] bool empty() const;
+        void drain();
+        void rotate();
+        void run();
+        void stop();
+
     public:
         FileLogger(FileLogger &) = delete;
 
@@ -35,7 +89,8 @@ namespace OWC {
 
         static FileLogger *getInstance();
         [[nodiscard]] bool init();
-        void write(const std::wstring &msg, std::source_location loc = std::source_location::current());
+        [[nodiscard]] bool isEnabled(const LogLevel lvl) const { return static_cast<int>(lvl) <= OWC_LOG_MAX_LEVEL && lvl <= level && open.load(std::memory_order_relaxed); }
+        void write(const std::wstring &msg, LogLevel lvl = LogLevel::Info, std::source_location loc = std::source_location::current());
         void writeExt(const std::wstring &msg);
     };
 }
@@ -0,0 +1,126 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <filesystem>
+#ifdef __linux__
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "FileWatcher.h"
+
+namespace OWC {
+#ifdef __linux__
+    static volatile std::sig_atomic_t stopRequested = 0;
+
+    static void onStopSignal(int) {
+        stopRequested = 1;
+    }
+#endif
+
+    FileWatcher::~FileWatcher() {
+#ifdef __linux__
+        if (fd != -1)
+            close(fd);
+#endif
+    }
+
+    bool FileWatcher::init(const std::string &fileName) {
+#ifdef __linux__
+        const std::filesystem::path path = fileName;
+        const std::filesystem::path dir = path.has_parent_path() ? path.parent_path() : ".";
+        struct sigaction sa {};
+
+        baseName = path.filename().string();
+
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd == -1) {
+            std::cerr << "failed to init inotify: " << std::strerror(errno) << "\n";
+            return false;
+        }
+
+        if (inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+            std::cerr << "failed to watch " << dir.string() << ": " << std::strerror(errno) << "\n";
+            return false;
+        }
+
+        // no SA_RESTART, poll() must return on signal
+        sa.sa_handler = onStopSignal;
+        sigaction(SIGINT, &sa, nullptr);
+        sigaction(SIGTERM, &sa, nullptr);
+
+        return true;
+#else
+        std::cerr << "watch is not supported on this platform\n";
+        return false;
+#endif
+    }
+
+    bool FileWatcher::readEvents() const {
+#ifdef __linux__
+        alignas(inotify_event) char buf[4096];
+        bool hit = false;
+        ssize_t len;
+
+        while ((len = read(fd, buf, sizeof(buf))) > 0) {
+            for (const char *p = buf; p < buf + len;) {
+                const inotify_event *event = reinterpret_cast<const inotify_event *>(p);
+
+                if (event->len > 0 && baseName == event->name)
+                    hit = true;
+
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+
+        return hit;
+#else
+        return false;
+#endif
+    }
+
+    bool FileWatcher::wait(const int debounceMs) const {
+#ifdef __linux__
+        bool changed = false;
+
+        while (!stopRequested) {
+            pollfd pfd {fd, POLLIN, 0};
+            const int ret = poll(&pfd, 1, changed ? debounceMs : -1);
+
+            if (ret == -1 && errno == EINTR) {
+                continue;
+
+            } else if (ret == -1) {
+                std::cerr << "failed to watch file: " << std::strerror(errno) << "\n";
+                return false;
+
+            } else if (ret == 0) {
+                return true;
+            }
+
+            // editors save in bursts (write, chmod, rename), wait until they are done
+            changed = readEvents() || changed;
+        }
+#endif
+        return false;
+    }
+}
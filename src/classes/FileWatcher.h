@@ -0,0 +1,45 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+
+namespace OWC {
+    /*
+     * Waits for changes to a single file, for watch
+     *
+     * The parent directory is watched, so editors that save by writing a new file and renaming it over the old one are seen too.
+     */
+    class FileWatcher final {
+    private:
+        std::string baseName;
+        int fd = -1;
+
+        [[nodiscard]] bool readEvents() const;
+
+    public:
+        FileWatcher() = default;
+        FileWatcher(FileWatcher &) = delete;
+
+        ~FileWatcher();
+
+        [[nodiscard]] bool init(const std::string &fileName);
+        // returns once the file changed and then stayed quiet for debounceMs, false on SIGINT/SIGTERM or error
+        [[nodiscard]] bool wait(int debounceMs) const;
+    };
+}
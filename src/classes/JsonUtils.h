@@ -0,0 +1,48 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace OWC {
+    // quoted and escaped, for the hand written json of reports, traces and timelines
+    inline void appendJsonString(std::string &out, const std::string_view str) {
+        out += '"';
+
+        for (const char c: str) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+
+            } else if (c == '\n') {
+                out += "\\n";
+
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                std::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<int>(c));
+
+            } else {
+                out += c;
+            }
+        }
+
+        out += '"';
+    }
+}
@@ -0,0 +1,132 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <bit>
+
+#include "KeyTable.h"
+#include "../extern/libOpenWinControls/src/include/HIDUsageIDMap.h"
+#include "../extern/libOpenWinControls/src/include/XinputUsageIDMap.h"
+
+namespace OWC {
+    // usage IDs above this are not stored in the dense array, nameOf falls back to a scan
+    static constexpr int MaxDenseCode = 0xffff;
+
+    template<typename T>
+    KeyTable::KeyTable(const T &usageMap) {
+        int maxCode = -1;
+
+        for (const auto &[code, key]: usageMap) {
+            entries.push_back({&key, static_cast<int>(code)});
+
+            if (code <= MaxDenseCode)
+                maxCode = std::max(maxCode, static_cast<int>(code));
+        }
+
+        // load factor <= 0.5, probes stay short
+        slots.assign(std::bit_ceil(entries.size() * 2 + 1), -1);
+        mask = slots.size() - 1;
+        names.assign(maxCode + 1, nullptr);
+
+        for (int i=0,l=entries.size(); i<l; ++i) {
+            const Entry &ent = entries[i];
+            uint32_t pos = hash(*ent.name) & mask;
+
+            while (slots[pos] != -1)
+                pos = (pos + 1) & mask;
+
+            slots[pos] = i;
+
+            if (ent.code >= 0 && ent.code <= maxCode)
+                names[ent.code] = ent.name;
+        }
+    }
+
+    const KeyTable &KeyTable::getHID() {
+        static const KeyTable table (HIDUsageIDMap);
+
+        return table;
+    }
+
+    const KeyTable &KeyTable::getXinput() {
+        static const KeyTable table (XinputUsageIDMap);
+
+        return table;
+    }
+
+    uint32_t KeyTable::hash(const std::string_view name) {
+        uint32_t h = 2166136261u;
+
+        for (const char c: name) {
+            h ^= static_cast<uint8_t>(c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c);
+            h *= 16777619u;
+        }
+
+        return h;
+    }
+
+    bool KeyTable::equals(const std::string_view a, const std::string_view b) {
+        if (a.size() != b.size())
+            return false;
+
+        for (size_t i=0,l=a.size(); i<l; ++i) {
+            const char ca = a[i] >= 'a' && a[i] <= 'z' ? a[i] - ('a' - 'A') : a[i];
+            const char cb = b[i] >= 'a' && b[i] <= 'z' ? b[i] - ('a' - 'A') : b[i];
+
+            if (ca != cb)
+                return false;
+        }
+
+        return true;
+    }
+
+    int KeyTable::findEntry(const std::string_view name) const {
+        if (slots.empty())
+            return -1;
+
+        for (uint32_t pos = hash(name) & mask; slots[pos] != -1; pos = (pos + 1) & mask) {
+            if (equals(*entries[slots[pos]].name, name))
+                return slots[pos];
+        }
+
+        return -1;
+    }
+
+    const std::string *KeyTable::resolve(const std::string_view name) const {
+        const int idx = findEntry(name);
+
+        return idx == -1 ? nullptr : entries[idx].name;
+    }
+
+    int KeyTable::find(const std::string_view name) const {
+        const int idx = findEntry(name);
+
+        return idx == -1 ? -1 : entries[idx].code;
+    }
+
+    std::string_view KeyTable::nameOf(const int code) const {
+        if (code >= 0 && code < static_cast<int>(names.size()))
+            return names[code] ? std::string_view(*names[code]) : std::string_view();
+
+        for (const Entry &ent: entries) {
+            if (ent.code == code)
+                return *ent.name;
+        }
+
+        return {};
+    }
+}
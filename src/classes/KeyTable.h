@@ -0,0 +1,64 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace OWC {
+    /*
+     * Key name <-> usage ID lookup over the library usage ID maps
+     *
+     * Names are matched case-insensitively through an open addressing table hashed on the upper-cased name,
+     * usage IDs index a dense array. Both are built once on first use and never modified after.
+     */
+    class KeyTable final {
+    private:
+        struct Entry final {
+            const std::string *name;
+            int code;
+        };
+
+        std::vector<Entry> entries;
+        std::vector<int16_t> slots;
+        std::vector<const std::string *> names;
+        uint32_t mask = 0;
+
+        template<typename T>
+        explicit KeyTable(const T &usageMap);
+
+        [[nodiscard]] static uint32_t hash(std::string_view name);
+        [[nodiscard]] static bool equals(std::string_view a, std::string_view b);
+        [[nodiscard]] int findEntry(std::string_view name) const;
+
+    public:
+        KeyTable(KeyTable &) = delete;
+
+        [[nodiscard]] static const KeyTable &getHID();
+        [[nodiscard]] static const KeyTable &getXinput();
+
+        // canonical key name as accepted by the controller setters, nullptr if unknown
+        [[nodiscard]] const std::string *resolve(std::string_view name) const;
+        // usage ID, -1 if unknown
+        [[nodiscard]] int find(std::string_view name) const;
+        // key name, empty if unknown
+        [[nodiscard]] std::string_view nameOf(int code) const;
+    };
+}
@@ -0,0 +1,253 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <charconv>
+#include <cctype>
+#include <format>
+#include <map>
+
+#include "MacroCompiler.h"
+#include "KeyTable.h"
+
+namespace OWC {
+    [[nodiscard]]
+    static std::string_view trim(std::string_view str) {
+        const size_t start = str.find_first_not_of(" \t");
+
+        if (start == std::string_view::npos)
+            return {};
+
+        return str.substr(start, str.find_last_not_of(" \t") - start + 1);
+    }
+
+    void Macro::fill(const int num, const int controllerType, ConfigImage &img) const {
+        const int slotCount = controllerType == 1 ? 4 : ConfigImage::Slots;
+
+        for (int i=1; i<=slotCount; ++i) {
+            const MacroSlot *slot = i <= static_cast<int>(slots.size()) ? &slots[i - 1] : nullptr;
+
+            img.backButtonKeys[num - 1][i - 1] = slot ? slot->key : "UNSET";
+            img.backButtonStartTimes[num - 1][i - 1] = controllerType == 1 && i == 4 ? startDelay : (slot ? slot->start : 0);
+            img.present.set(ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::Key));
+            img.present.set(ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::StartTime));
+
+            if (controllerType != 1) {
+                img.backButtonHoldTimes[num - 1][i - 1] = slot ? slot->hold : 0;
+                img.present.set(ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::HoldTime));
+            }
+        }
+
+        if (controllerType != 1) {
+            img.activeSlots[num - 1] = slots.size();
+            img.present.set(ConfigImage::fieldActiveSlots(num));
+        }
+    }
+
+    bool MacroCompiler::parseMs(std::string_view str, int &out) {
+        const char *end;
+
+        str = trim(str);
+        if (str.ends_with("ms"))
+            str = trim(str.substr(0, str.size() - 2));
+
+        end = str.data() + str.size();
+        return !str.empty() && std::from_chars(str.data(), end, out).ptr == end && out >= 0 && out <= MaxTime;
+    }
+
+    bool MacroCompiler::isModifier(const std::string &key) {
+        const int code = KeyTable::getHID().find(key);
+
+        // HID keyboard page, left control to right gui
+        return code >= 0xe0 && code <= 0xe7;
+    }
+
+    bool MacroCompiler::parseStep(std::string_view str, const int controllerType, Step &step, std::string &error) {
+        const size_t at = str.find('@');
+        size_t star;
+
+        if (str.starts_with("wait") && (str.size() == 4 || str[4] == ' ' || str[4] == '\t' || std::isdigit(static_cast<unsigned char>(str[4])))) {
+            if (!parseMs(str.substr(4), step.wait)) {
+                error = std::format("invalid wait '{}'", str);
+                return false;
+            }
+
+            return true;
+        }
+
+        if (at != std::string_view::npos) {
+            if (controllerType == 1) {
+                error = "hold times are V2 only";
+                return false;
+
+            } else if (!parseMs(str.substr(at + 1), step.hold) || step.hold == 0) {
+                error = std::format("invalid hold time in '{}'", str);
+                return false;
+            }
+
+            str = trim(str.substr(0, at));
+        }
+
+        star = str.find('*');
+        if (star != std::string_view::npos) {
+            const std::string_view count = trim(str.substr(star + 1));
+            const char *end = count.data() + count.size();
+
+            if (count.empty() || std::from_chars(count.data(), end, step.count).ptr != end || step.count < 1 || step.count > ConfigImage::Slots) {
+                error = std::format("invalid repeat count in '{}'", str);
+                return false;
+            }
+
+            str = trim(str.substr(0, star));
+        }
+
+        while (true) {
+            const size_t plus = str.find('+');
+            const std::string_view name = trim(str.substr(0, plus));
+            const std::string *key = KeyTable::getHID().resolve(name);
+
+            if (name.empty()) {
+                error = "missing key";
+                return false;
+
+            } else if (!key) {
+                error = std::format("unknown key {}", name);
+                return false;
+
+            } else if (std::ranges::find(step.keys, *key) != step.keys.end()) {
+                error = std::format("{} is pressed twice in a chord", name);
+                return false;
+            }
+
+            step.keys.push_back(*key);
+
+            if (plus == std::string_view::npos)
+                break;
+
+            str.remove_prefix(plus + 1);
+        }
+
+        return true;
+    }
+
+    bool MacroCompiler::compile(std::string_view src, const int controllerType, Macro &macro, std::string &error) {
+        const bool holds = controllerType != 1;
+        const int budget = controllerType == 1 ? V1Slots : ConfigImage::Slots;
+        std::map<std::string, int> released; // key -> release time of its last press
+        std::map<std::string, int> carried; // modifier -> slot of the previous press, still held
+        std::vector<Step> steps;
+        Macro tmp;
+        int t = 0;
+
+        while (!src.empty()) {
+            const size_t semi = src.find(';');
+            const std::string_view str = trim(src.substr(0, semi));
+            Step step;
+
+            src.remove_prefix(semi == std::string_view::npos ? src.size() : semi + 1);
+
+            // a trailing ';' is fine
+            if (str.empty() && src.empty() && !steps.empty())
+                break;
+
+            if (str.empty()) {
+                error = "empty step";
+                return false;
+
+            } else if (!parseStep(str, controllerType, step, error)) {
+                return false;
+            }
+
+            steps.push_back(std::move(step));
+        }
+
+        if (steps.empty()) {
+            error = "empty macro";
+            return false;
+        }
+
+        for (const Step &step: steps) {
+            const int hold = step.hold > 0 ? step.hold : DefaultHold;
+
+            if (step.wait >= 0) {
+                // nothing pressed yet, V1 has a dedicated start time for that
+                if (controllerType == 1 && tmp.slots.empty())
+                    tmp.startDelay += step.wait;
+                else
+                    t += step.wait;
+
+                carried.clear();
+                continue;
+            }
+
+            for (int rep=0; rep<step.count; ++rep) {
+                std::map<std::string, int> held;
+                int start = t;
+
+                for (const std::string &key: step.keys) {
+                    const auto it = released.find(key);
+
+                    if (it != released.end() && !(holds && carried.contains(key)))
+                        start = std::max(start, it->second + ReleaseGap);
+                }
+
+                for (const std::string &key: step.keys) {
+                    const auto it = holds ? carried.find(key) : carried.end();
+                    int slot;
+
+                    if (it != carried.end()) {
+                        slot = it->second;
+                        tmp.slots[slot].hold = start + hold - tmp.slots[slot].start;
+
+                    } else {
+                        slot = tmp.slots.size();
+                        tmp.slots.push_back({key, start, holds ? hold : 0});
+                    }
+
+                    released[key] = start + hold;
+
+                    if (holds && isModifier(key))
+                        held.emplace(key, slot);
+                }
+
+                // modifiers the next press does not share are released with this one
+                carried = std::move(held);
+                t = start + hold;
+            }
+        }
+
+        // V1 has no hold times, the macro is over when its last key is pressed
+        tmp.duration = holds ? t : (tmp.slots.empty() ? 0 : tmp.slots.back().start);
+        std::ranges::stable_sort(tmp.slots, {}, &MacroSlot::start);
+
+        if (static_cast<int>(tmp.slots.size()) > budget) {
+            error = std::format("macro needs {} slots, {} available", tmp.slots.size(), budget);
+            return false;
+
+        } else if (tmp.slots.empty()) {
+            error = "macro presses no key";
+            return false;
+
+        } else if (tmp.startDelay > MaxTime || std::ranges::any_of(tmp.slots, [](const MacroSlot &s) { return s.start + s.hold > MaxTime; })) {
+            error = std::format("macro is longer than {} ms", MaxTime);
+            return false;
+        }
+
+        macro = std::move(tmp);
+        return true;
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ConfigImage.h"
+
+namespace OWC {
+    struct MacroSlot final {
+        std::string key;
+        int start; // ms from the macro start
+        int hold; // ms, V2 only
+    };
+
+    struct Macro final {
+        std::vector<MacroSlot> slots; // in start order
+        int startDelay = 0; // V1 macro start time, from leading waits
+        int duration = 0;
+
+        // sets every slot of back button num, the ones the macro does not use are cleared
+        void fill(int num, int controllerType, ConfigImage &img) const;
+    };
+
+    /*
+     * Back button macro language, compiled to the V1 or V2 slot layout
+     *
+     *   ctrl+shift+esc; wait 40; f13*3 @20ms
+     *
+     * Steps are separated by ';' and run in order. a+b is a chord, its keys share a start time. *n repeats a step,
+     * @n sets its hold time (V2 only, default 50 ms), wait n delays the next step.
+     * A step starts as soon as the previous one is released, a key pressed again first waits ReleaseGap ms.
+     * On V2 a modifier held by consecutive steps stays pressed in a single slot, on V1 leading waits become the macro start time.
+     */
+    class MacroCompiler final {
+    private:
+        struct Step final {
+            std::vector<std::string> keys;
+            int count = 1;
+            int hold = 0; // 0 = default
+            int wait = -1; // >= 0 for wait steps
+        };
+
+        [[nodiscard]] static bool parseMs(std::string_view str, int &out);
+        [[nodiscard]] static bool parseStep(std::string_view str, int controllerType, Step &step, std::string &error);
+
+    public:
+        static constexpr int DefaultHold = 50;
+        static constexpr int ReleaseGap = 10;
+        static constexpr int MaxTime = 65535;
+        static constexpr int V1Slots = 3; // the 4th V1 slot time is the macro start time
+
+        MacroCompiler() = delete;
+
+        // HID keyboard modifiers, they are bits in the report instead of key slots
+        [[nodiscard]] static bool isModifier(const std::string &key);
+
+        // controllerType 0 checks syntax, key names and the V2 slot budget only
+        [[nodiscard]] static bool compile(std::string_view src, int controllerType, Macro &macro, std::string &error);
+    };
+}
@@ -0,0 +1,217 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <format>
+#include <map>
+
+#include "MacroTimeline.h"
+#include "JsonUtils.h"
+#include "KeyTable.h"
+#include "../include/Options.h"
+
+namespace OWC {
+    // keys that take one of the report key slots, modifiers and non keyboard keys do not
+    [[nodiscard]]
+    static bool takesReportSlot(const std::string &key) {
+        const int code = KeyTable::getHID().find(key);
+
+        return code >= 0 && !MacroCompiler::isModifier(key);
+    }
+
+    bool MacroTimeline::build(const ConfigImage &img, const int num) {
+        if (num < 1 || num > ConfigImage::BackButtons || !img.present.test(ConfigImage::fieldActiveSlots(num)))
+            return false;
+
+        const int activeSlots = std::clamp(img.activeSlots[num - 1], 0, ConfigImage::Slots);
+
+        button = BackButtonNames[num - 1];
+        totalSlots = ConfigImage::Slots;
+
+        for (int slot=1; slot<=ConfigImage::Slots; ++slot) {
+            const std::string &key = img.backButtonKeys[num - 1][slot - 1];
+            const int start = img.backButtonStartTimes[num - 1][slot - 1];
+            const int hold = img.backButtonHoldTimes[num - 1][slot - 1];
+
+            if (slot > activeSlots) {
+                if (!key.empty() && key != "UNSET")
+                    issues.push_back({"inactive", start, std::format("slot {} ({}) is past the {} active slots and never plays", slot, key, activeSlots)});
+
+                continue;
+            }
+
+            slots.push_back({key, start, hold});
+            if (start < 0 || hold < 0) {
+                issues.push_back({"negative", start, std::format("slot {} has a negative {} time and never plays", slot, start < 0 ? "start" : "hold")});
+                continue;
+            }
+
+            checkSlot(slot);
+
+            if (key.empty() || key == "UNSET")
+                continue;
+
+            events.push_back({start, slot, true});
+            events.push_back({start + hold, slot, false});
+            duration = std::max(duration, start + hold);
+        }
+
+        // zero-length presses keep their press first
+        std::ranges::stable_sort(events, [this](const MacroEvent &a, const MacroEvent &b) {
+            const auto rank = [this](const MacroEvent &e) { return e.press ? 1 : (slots[e.slot - 1].hold == 0 ? 2 : 0); };
+
+            return std::make_tuple(a.time, rank(a), a.slot) < std::make_tuple(b.time, rank(b), b.slot);
+        });
+
+        checkRollover();
+        std::ranges::stable_sort(issues, {}, &MacroIssue::time);
+        return true;
+    }
+
+    void MacroTimeline::checkSlot(const int slot) {
+        const MacroSlot &cur = slots[slot - 1];
+        const int end = cur.start + cur.hold;
+
+        if (cur.key.empty() || cur.key == "UNSET") {
+            issues.push_back({"unset", cur.start, std::format("slot {} is active but has no key", slot)});
+            return;
+        }
+
+        if (cur.hold == 0)
+            issues.push_back({"zero-length", cur.start, std::format("slot {} holds {} for 0 ms, the host may never see the press", slot, cur.key)});
+
+        for (int i=1; i<slot; ++i) {
+            const MacroSlot &prev = slots[i - 1];
+            const int prevEnd = prev.start + prev.hold;
+
+            if (prev.key != cur.key || prev.start < 0 || prev.hold < 0)
+                continue;
+
+            if (cur.start < prevEnd && prev.start < end)
+                issues.push_back({"overlap", std::max(cur.start, prev.start), std::format("slots {} and {} both hold {} from {} to {} ms, the later press is lost",
+                    i, slot, cur.key, std::max(cur.start, prev.start), std::min(end, prevEnd))});
+            else if (cur.start == prevEnd || prev.start == end)
+                issues.push_back({"retrigger", std::max(cur.start, prev.start), std::format("slots {} and {} release and press {} at {} ms, the host may see a single press",
+                    i, slot, cur.key, std::max(cur.start, prev.start))});
+        }
+    }
+
+    void MacroTimeline::checkRollover() {
+        std::map<std::string, int> down; // key -> slots holding it
+        bool over = false;
+
+        for (const MacroEvent &ev: events) {
+            const std::string &key = slots[ev.slot - 1].key;
+
+            if (!takesReportSlot(key))
+                continue;
+
+            if (!ev.press) {
+                if (--down[key] == 0)
+                    down.erase(key);
+
+                over = over && down.size() > RolloverKeys;
+                continue;
+            }
+
+            ++down[key];
+            if (over || down.size() <= RolloverKeys)
+                continue;
+
+            over = true;
+            issues.push_back({"rollover", ev.time, std::format("{} keys are down at {} ms, slot {} ({}) does not fit a {}-key report",
+                down.size(), ev.time, ev.slot, key, RolloverKeys)});
+        }
+    }
+
+    std::string MacroTimeline::toText() const {
+        const int msPerCol = std::max(1, (duration + TextWidth - 1) / TextWidth);
+        std::string out;
+
+        std::format_to(std::back_inserter(out), "=== {} Macro Timeline ===\n\n"
+            "Active slots:\t{} of {}\n"
+            "Duration:\t{} ms\n"
+            "Scale:\t\t{} ms per column\n\n", button, slots.size(), totalSlots, duration, msPerCol);
+
+        for (size_t i=0,l=slots.size(); i<l; ++i) {
+            const MacroSlot &slot = slots[i];
+            std::string bar (TextWidth, ' ');
+
+            if (!slot.key.empty() && slot.key != "UNSET" && slot.start >= 0 && slot.hold >= 0) {
+                const int first = std::min(slot.start / msPerCol, TextWidth);
+                const int last = std::min(slot.hold > 0 ? (slot.start + slot.hold - 1) / msPerCol : first, TextWidth - 1);
+
+                for (int c=first; c<=last; ++c)
+                    bar[c] = slot.hold > 0 ? '#' : '|';
+            }
+
+            std::format_to(std::back_inserter(out), "{:>2} {:<14} {:>5} +{:<5} [{}]\n", i + 1, slot.key, slot.start, slot.hold, bar);
+        }
+
+        if (events.empty()) {
+            out += "No key presses\n";
+            return out;
+        }
+
+        out += "\nEvents:\n\n";
+        for (const MacroEvent &ev: events)
+            std::format_to(std::back_inserter(out), "{:>7} ms  {:<7}  {} (slot {})\n", ev.time, ev.press ? "press" : "release", slots[ev.slot - 1].key, ev.slot);
+
+        if (issues.empty()) {
+            out += "\nNo issues found\n";
+            return out;
+        }
+
+        out += "\nIssues:\n\n";
+        for (const MacroIssue &issue: issues)
+            std::format_to(std::back_inserter(out), "  {}: {}\n", issue.type, issue.message);
+
+        return out;
+    }
+
+    std::string MacroTimeline::toJson() const {
+        std::string out;
+
+        out += "{\n  \"button\": ";
+        appendJsonString(out, button);
+        std::format_to(std::back_inserter(out), ",\n  \"activeSlots\": {},\n  \"duration\": {},\n  \"slots\": [", slots.size(), duration);
+
+        for (size_t i=0,l=slots.size(); i<l; ++i) {
+            std::format_to(std::back_inserter(out), "{}\n    {{\"slot\": {}, \"key\": ", i > 0 ? "," : "", i + 1);
+            appendJsonString(out, slots[i].key);
+            std::format_to(std::back_inserter(out), ", \"start\": {}, \"hold\": {}}}", slots[i].start, slots[i].hold);
+        }
+
+        out += slots.empty() ? "],\n  \"events\": [" : "\n  ],\n  \"events\": [";
+        for (size_t i=0,l=events.size(); i<l; ++i) {
+            std::format_to(std::back_inserter(out), "{}\n    {{\"time\": {}, \"type\": \"{}\", \"slot\": {}, \"key\": ", i > 0 ? "," : "",
+                events[i].time, events[i].press ? "press" : "release", events[i].slot);
+            appendJsonString(out, slots[events[i].slot - 1].key);
+            out += '}';
+        }
+
+        out += events.empty() ? "],\n  \"issues\": [" : "\n  ],\n  \"issues\": [";
+        for (size_t i=0,l=issues.size(); i<l; ++i) {
+            std::format_to(std::back_inserter(out), "{}\n    {{\"type\": \"{}\", \"time\": {}, \"message\": ", i > 0 ? "," : "", issues[i].type, issues[i].time);
+            appendJsonString(out, issues[i].message);
+            out += '}';
+        }
+
+        out += issues.empty() ? "]\n}\n" : "\n  ]\n}\n";
+        return out;
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ConfigImage.h"
+#include "MacroCompiler.h"
+
+namespace OWC {
+    struct MacroEvent final {
+        int time; // ms from the button press
+        int slot; // 1-based
+        bool press;
+    };
+
+    struct MacroIssue final {
+        std::string_view type; // overlap, retrigger, zero-length, unset, inactive, negative or rollover
+        int time;
+        std::string message;
+    };
+
+    /*
+     * Playback of a V2 back button macro, expanded from the slots of a config image for simulate
+     *
+     * Each active slot presses its key at its start time and releases it hold time ms later. At the same ms releases come
+     * before presses, so a key pressed again right away is released first. Rollover assumes a boot keyboard report,
+     * modifiers are bits and at most RolloverKeys other keys are down at once.
+     */
+    class MacroTimeline final {
+    private:
+        std::string button;
+        std::vector<MacroSlot> slots; // active slots, slot n is at n - 1
+        std::vector<MacroEvent> events;
+        std::vector<MacroIssue> issues;
+        int totalSlots = 0;
+        int duration = 0;
+
+        void checkSlot(int slot);
+        void checkRollover();
+
+    public:
+        static constexpr int RolloverKeys = 6;
+        static constexpr int TextWidth = 60;
+
+        // false if the image has no slots for back button num
+        [[nodiscard]] bool build(const ConfigImage &img, int num);
+        [[nodiscard]] const std::vector<MacroIssue> &getIssues() const { return issues; }
+        [[nodiscard]] std::string toText() const;
+        [[nodiscard]] std::string toJson() const;
+    };
+}
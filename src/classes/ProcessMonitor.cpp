@@ -0,0 +1,262 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <charconv>
+#include <algorithm>
+#ifdef __linux__
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+#endif
+
+#include "ProcessMonitor.h"
+
+namespace OWC {
+#ifdef __linux__
+    static volatile std::sig_atomic_t stopRequested = 0;
+
+    static void onStopSignal(int) {
+        stopRequested = 1;
+    }
+#endif
+
+    ProcessMonitor::ProcessMonitor(const int pollMs): pollMs(pollMs) {}
+
+    ProcessMonitor::~ProcessMonitor() {
+#ifdef __linux__
+        if (sockFd != -1)
+            close(sockFd);
+#endif
+    }
+
+    bool ProcessMonitor::initNetlink() {
+#ifdef __linux__
+        constexpr proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+        alignas(nlmsghdr) char buf[NLMSG_SPACE(sizeof(cn_msg) + sizeof(op))] {};
+        nlmsghdr *nlh = reinterpret_cast<nlmsghdr *>(buf);
+        cn_msg *msg = static_cast<cn_msg *>(NLMSG_DATA(nlh));
+        sockaddr_nl addr {};
+        const int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+
+        if (fd == -1)
+            return false;
+
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = CN_IDX_PROC;
+
+        nlh->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(op));
+        nlh->nlmsg_type = NLMSG_DONE;
+        msg->id.idx = CN_IDX_PROC;
+        msg->id.val = CN_VAL_PROC;
+        msg->len = sizeof(op);
+        std::memcpy(msg->data, &op, sizeof(op));
+
+        // bind and send succeed without CAP_NET_ADMIN, the kernel refuses in the ack instead
+        if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1 || send(fd, buf, nlh->nlmsg_len, 0) == -1 || !readAck(fd)) {
+            close(fd);
+            return false;
+        }
+
+        sockFd = fd;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool ProcessMonitor::readAck(const int fd) {
+#ifdef __linux__
+        alignas(nlmsghdr) char buf[1024];
+        pollfd pfd {fd, POLLIN, 0};
+
+        while (poll(&pfd, 1, AckTimeoutMs) > 0) {
+            ssize_t len = recv(fd, buf, sizeof(buf), 0);
+
+            if (len == -1 && errno == EINTR)
+                continue;
+            else if (len <= 0)
+                return false;
+
+            for (nlmsghdr *nlh = reinterpret_cast<nlmsghdr *>(buf); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+                const cn_msg *msg = static_cast<const cn_msg *>(NLMSG_DATA(nlh));
+                const proc_event *event;
+
+                if (nlh->nlmsg_type != NLMSG_DONE || msg->id.idx != CN_IDX_PROC || msg->id.val != CN_VAL_PROC)
+                    continue;
+
+                // an event before the ack means we are subscribed, init() rescans /proc anyway
+                event = reinterpret_cast<const proc_event *>(msg->data);
+                return event->what != proc_event::PROC_EVENT_NONE || event->event_data.ack.err == 0;
+            }
+        }
+
+        // no ack, do not wait on a socket that may never deliver
+        return false;
+#else
+        return false;
+#endif
+    }
+
+    void ProcessMonitor::readNetlink() {
+#ifdef __linux__
+        alignas(nlmsghdr) char buf[8192];
+        ssize_t len;
+
+        while ((len = recv(sockFd, buf, sizeof(buf), MSG_DONTWAIT)) != 0) {
+            if (len == -1) {
+                // events were dropped, rebuild the process list
+                if (errno == ENOBUFS)
+                    scanProc();
+
+                if (errno == EINTR || errno == ENOBUFS)
+                    continue;
+
+                return;
+            }
+
+            for (nlmsghdr *nlh = reinterpret_cast<nlmsghdr *>(buf); NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+                const cn_msg *msg = static_cast<const cn_msg *>(NLMSG_DATA(nlh));
+                const proc_event *event;
+                std::chrono::steady_clock::time_point time;
+
+                if (nlh->nlmsg_type != NLMSG_DONE || msg->id.idx != CN_IDX_PROC || msg->id.val != CN_VAL_PROC)
+                    continue;
+
+                event = reinterpret_cast<const proc_event *>(msg->data);
+                // the kernel stamps events with the monotonic clock, like steady_clock
+                time = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(event->timestamp_ns));
+
+                if (event->what == proc_event::PROC_EVENT_EXEC) {
+                    known.insert(event->event_data.exec.process_tgid);
+                    pending.emplace_back(true, event->event_data.exec.process_tgid, time);
+
+                } else if (event->what == proc_event::PROC_EVENT_EXIT && event->event_data.exit.process_pid == event->event_data.exit.process_tgid) {
+                    known.erase(event->event_data.exit.process_tgid);
+                    pending.emplace_back(false, event->event_data.exit.process_tgid, time);
+                }
+            }
+        }
+#endif
+    }
+
+    void ProcessMonitor::scanProc() {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::unordered_set<int> running;
+        std::error_code ec;
+
+        for (const std::filesystem::directory_entry &entry: std::filesystem::directory_iterator("/proc", ec)) {
+            const std::string name = entry.path().filename().string();
+            int pid;
+
+            if (std::from_chars(name.data(), name.data() + name.size(), pid).ec == std::errc())
+                running.insert(pid);
+        }
+
+        for (const int pid: running) {
+            if (!known.contains(pid))
+                pending.emplace_back(true, pid, now);
+        }
+
+        for (const int pid: known) {
+            if (!running.contains(pid))
+                pending.emplace_back(false, pid, now);
+        }
+
+        known = std::move(running);
+    }
+
+    bool ProcessMonitor::init() {
+#ifdef __linux__
+        struct sigaction sa {};
+
+        if (!initNetlink())
+            std::cerr << "proc connector not available (needs CAP_NET_ADMIN), polling /proc every " << pollMs << " ms\n";
+
+        // no SA_RESTART, poll() must return on signal
+        sa.sa_handler = onStopSignal;
+        sigaction(SIGINT, &sa, nullptr);
+        sigaction(SIGTERM, &sa, nullptr);
+
+        scanProc();
+        return true;
+#else
+        std::cerr << "autoswitch is not supported on this platform\n";
+        return false;
+#endif
+    }
+
+    bool ProcessMonitor::wait(std::vector<ProcessEvent> &events) {
+#ifdef __linux__
+        while (!stopRequested) {
+            if (!pending.empty()) {
+                events.swap(pending);
+                pending.clear();
+                return true;
+            }
+
+            if (sockFd != -1) {
+                pollfd pfd {sockFd, POLLIN, 0};
+
+                if (poll(&pfd, 1, -1) > 0)
+                    readNetlink();
+
+            } else if (poll(nullptr, 0, pollMs) == 0) {
+                scanProc();
+            }
+        }
+#endif
+        return false;
+    }
+
+    bool ProcessMonitor::readProcess(const int pid, std::string &exe, std::string &cmdline) {
+        const std::filesystem::path proc = std::filesystem::path("/proc") / std::to_string(pid);
+        std::ifstream ifs;
+        std::error_code ec;
+        const std::filesystem::path target = std::filesystem::read_symlink(proc / "exe", ec);
+
+        if (!ec) {
+            exe = target.filename().string();
+
+        } else {
+            ifs.open(proc / "comm");
+
+            if (!std::getline(ifs, exe))
+                return false;
+
+            ifs.close();
+        }
+
+        ifs.open(proc / "cmdline", std::ios::binary);
+        cmdline.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+
+        // arguments are NUL separated
+        std::ranges::replace(cmdline, '\0', ' ');
+        while (!cmdline.empty() && cmdline.back() == ' ')
+            cmdline.pop_back();
+
+        return true;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace OWC {
+    struct ProcessEvent final {
+        bool exec; // else exit
+        int pid;
+        std::chrono::steady_clock::time_point time; // when the kernel saw it, detection time when polling
+    };
+
+    /*
+     * Process start and exit notifications for autoswitch
+     *
+     * Uses the netlink proc connector, which needs CAP_NET_ADMIN, and falls back to polling /proc.
+     * Polling only sees pids come and go, an exec that keeps the pid is missed.
+     * Processes that are already running are reported as exec events by the first wait().
+     */
+    class ProcessMonitor final {
+    private:
+        static constexpr int AckTimeoutMs = 1000;
+
+        std::unordered_set<int> known;
+        std::vector<ProcessEvent> pending;
+        int sockFd = -1;
+        int pollMs;
+
+        [[nodiscard]] bool initNetlink();
+        // the kernel acks PROC_CN_MCAST_LISTEN with EPERM when the caller lacks CAP_NET_ADMIN
+        [[nodiscard]] static bool readAck(int fd);
+        void readNetlink();
+        void scanProc();
+
+    public:
+        explicit ProcessMonitor(int pollMs);
+        ProcessMonitor(ProcessMonitor &) = delete;
+
+        ~ProcessMonitor();
+
+        [[nodiscard]] bool init();
+        [[nodiscard]] bool usesNetlink() const { return sockFd != -1; }
+        // false on SIGINT/SIGTERM
+        [[nodiscard]] bool wait(std::vector<ProcessEvent> &events);
+        // exe is the executable file name, or comm when the link cannot be read
+        [[nodiscard]] static bool readProcess(int pid, std::string &exe, std::string &cmdline);
+    };
+}
@@ -0,0 +1,613 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <fstream>
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cctype>
+#include <format>
+#include <vector>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ProfileReader.h"
+#include "../include/Options.h"
+#include "KeyTable.h"
+#include "BinaryProfile.h"
+#include "MacroCompiler.h"
+#include "Tracer.h"
+#include "../extern/yaml-cpp/include/yaml-cpp/yaml.h"
+
+namespace OWC {
+    static constexpr int MappingTypeField = -1;
+    // L4_MACRO, the other back buttons follow downwards
+    static constexpr int MacroField = -2;
+    /*
+     * profile key name -> config image field
+     *
+     * controllerType: 0 = any, the key is skipped on other controller types, as the yaml-cpp import does
+     */
+    class ProfileIndex final {
+    private:
+        struct Entry final {
+            std::string name;
+            int field;
+            int controllerType;
+        };
+
+        std::vector<Entry> entries;
+        std::vector<int16_t> slots;
+        std::array<const std::string *, ConfigImage::FieldCount> fieldNames {};
+        uint32_t mask = 0;
+
+        [[nodiscard]] static uint32_t hash(const std::string_view name) {
+            uint32_t h = 2166136261u;
+
+            for (const char c: name) {
+                h ^= static_cast<uint8_t>(c);
+                h *= 16777619u;
+            }
+
+            return h;
+        }
+
+        void add(std::string name, const int field, const int controllerType) {
+            entries.push_back({std::move(name), field, controllerType});
+        }
+
+    public:
+        ProfileIndex() {
+            add("MAPPING_TYPE", MappingTypeField, 0);
+
+            for (int i=0; i<ConfigImage::KbmFields; ++i)
+                add(std::string(ConfigImage::KbmButtons[i].first), ConfigImage::fieldKbm(i), 0);
+
+            for (int i=0; i<ConfigImage::XinputFields; ++i)
+                add(std::string(ConfigImage::XinputButtons[i].first), ConfigImage::fieldXinput(i), 0);
+
+            for (int num=1; num<=ConfigImage::BackButtons; ++num) {
+                const std::string_view btn = BackButtonNames[num - 1];
+
+                // V1 has 4 key slots for L4/R4, 3 start times and a macro start time stored in the 4th slot
+                for (int i=1; i<=ConfigImage::Slots; ++i) {
+                    add(std::format("{}_K{}", btn, i), ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::Key), num <= 2 && i <= 4 ? 0 : 2);
+                    add(std::format("{}_K{}_START_TIME", btn, i), ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::StartTime), num <= 2 && i <= 3 ? 0 : 2);
+                    add(std::format("{}_K{}_HOLD_TIME", btn, i), ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::HoldTime), 2);
+                }
+
+                add(std::format("{}_ACTIVE_SLOTS", btn), ConfigImage::fieldActiveSlots(num), 2);
+                add(std::format("{}_MACRO", btn), MacroField - (num - 1), num <= 2 ? 0 : 2);
+
+                if (num <= 2)
+                    add(std::format("{}_MACRO_START_TIME", btn), ConfigImage::fieldBackButton(num, 4, ConfigImage::SlotField::StartTime), 1);
+            }
+
+            slots.assign(std::bit_ceil(entries.size() * 2 + 1), -1);
+            mask = slots.size() - 1;
+
+            for (int i=0,l=entries.size(); i<l; ++i) {
+                uint32_t pos = hash(entries[i].name) & mask;
+
+                while (slots[pos] != -1)
+                    pos = (pos + 1) & mask;
+
+                slots[pos] = i;
+
+                if (entries[i].field >= 0)
+                    fieldNames[entries[i].field] = &entries[i].name;
+            }
+        }
+
+        [[nodiscard]] const Entry *find(const std::string_view name) const {
+            for (uint32_t pos = hash(name) & mask; slots[pos] != -1; pos = (pos + 1) & mask) {
+                if (entries[slots[pos]].name == name)
+                    return &entries[slots[pos]];
+            }
+
+            return nullptr;
+        }
+
+        [[nodiscard]] const std::string &fieldName(const int field) const {
+            return *fieldNames[field];
+        }
+    };
+
+    [[nodiscard]]
+    static const ProfileIndex &getIndex() {
+        static const ProfileIndex index;
+
+        return index;
+    }
+
+    [[nodiscard]]
+    static bool isBlank(const char c) {
+        return c == ' ' || c == '\t';
+    }
+
+    [[nodiscard]]
+    static std::string_view trim(std::string_view str) {
+        while (!str.empty() && isBlank(str.front()))
+            str.remove_prefix(1);
+
+        while (!str.empty() && isBlank(str.back()))
+            str.remove_suffix(1);
+
+        return str;
+    }
+
+    // strip comments and quotes from a value, false if it needs a real yaml parser
+    [[nodiscard]]
+    static bool parseScalar(std::string_view value, std::string_view &out) {
+        value = trim(value);
+
+        if (value.empty() || value == "~" || value == "null" || value == "Null" || value == "NULL")
+            return false;
+
+        if (value.front() == '\'' || value.front() == '"') {
+            const size_t end = value.find(value.front(), 1);
+            std::string_view rest;
+
+            if (end == std::string_view::npos)
+                return false;
+
+            out = value.substr(1, end - 1);
+            rest = trim(value.substr(end + 1));
+
+            if ((value.front() == '"' && out.find('\\') != std::string_view::npos) || (value.front() == '\'' && rest.starts_with('\'')))
+                return false;
+
+            return rest.empty() || rest.front() == '#';
+        }
+
+        if (std::strchr("[]{}&*!|>%@`,#", value.front()) || ((value.front() == '-' || value.front() == '?' || value.front() == ':') && (value.size() == 1 || isBlank(value[1]))))
+            return false;
+
+        for (size_t i=1,l=value.size(); i<l; ++i) {
+            if (value[i] == '#' && isBlank(value[i - 1])) {
+                value = trim(value.substr(0, i));
+                break;
+            }
+        }
+
+        if (value.back() == ':' || value.find(": ") != std::string_view::npos || value.find(":\t") != std::string_view::npos)
+            return false;
+
+        out = value;
+        return true;
+    }
+
+    [[nodiscard]]
+    static bool parseInt(const std::string_view value, int &out) {
+        const char *end = value.data() + value.size();
+
+        return std::from_chars(value.data(), end, out).ptr == end;
+    }
+
+    [[nodiscard]]
+    static bool isKeyField(const int field) {
+        if (field < ConfigImage::KbmFields + ConfigImage::XinputFields)
+            return true;
+        else if (field >= ConfigImage::fieldActiveSlots(1))
+            return false;
+
+        return (field - ConfigImage::fieldBackButton(1, 1, ConfigImage::SlotField::Key)) % 3 == static_cast<int>(ConfigImage::SlotField::Key);
+    }
+
+    // false if value is not a known key name
+    [[nodiscard]]
+    static bool storeKey(ConfigImage &img, const int field, const std::string_view value) {
+        const bool isXinput = field >= ConfigImage::KbmFields && field < ConfigImage::KbmFields + ConfigImage::XinputFields;
+        const std::string *key = (isXinput ? KeyTable::getXinput() : KeyTable::getHID()).resolve(value);
+
+        if (!key)
+            return false;
+
+        if (field < ConfigImage::KbmFields) {
+            img.kbm[field] = *key;
+
+        } else if (isXinput) {
+            img.xinput[field - ConfigImage::KbmFields] = *key;
+
+        } else {
+            const int idx = (field - ConfigImage::fieldBackButton(1, 1, ConfigImage::SlotField::Key)) / 3;
+
+            img.backButtonKeys[idx / ConfigImage::Slots][idx % ConfigImage::Slots] = *key;
+        }
+
+        return true;
+    }
+
+    static void storeInt(ConfigImage &img, const int field, const int value) {
+        if (field >= ConfigImage::fieldActiveSlots(1)) {
+            img.activeSlots[field - ConfigImage::fieldActiveSlots(1)] = std::clamp(value, 0, ConfigImage::Slots);
+            return;
+        }
+
+        const int idx = field - ConfigImage::fieldBackButton(1, 1, ConfigImage::SlotField::Key);
+        const int num = idx / (ConfigImage::Slots * 3);
+        const int slot = (idx / 3) % ConfigImage::Slots;
+
+        if (static_cast<ConfigImage::SlotField>(idx % 3) == ConfigImage::SlotField::StartTime)
+            img.backButtonStartTimes[num][slot] = value;
+        else
+            img.backButtonHoldTimes[num][slot] = value;
+    }
+
+    [[nodiscard]]
+    static bool checkMappingType(const int mappingType, const int controllerType, Diagnostics &diag) {
+        if (mappingType == -1) {
+            diag.error("mapping type missing, cannot apply mapping");
+            return false;
+
+        } else if (mappingType != controllerType) {
+            diag.error("wrong mapping type for this controller, cannot apply");
+            return false;
+        }
+
+        return true;
+    }
+
+    static void reportUnresolved(const std::vector<std::string_view> &unknown, const std::bitset<ConfigImage::FieldCount> &unresolved, Diagnostics &diag) {
+        for (const std::string_view key: unknown)
+            diag.warning(std::format("unknown key {}, ignored", key));
+
+        for (int i=0; i<ConfigImage::FieldCount; ++i) {
+            if (unresolved.test(i))
+                diag.error(std::format("failed to set {}", getIndex().fieldName(i)));
+        }
+    }
+
+    // after all other keys, a macro replaces the slot keys of its back button
+    static void compileMacros(const std::array<std::string, ConfigImage::BackButtons> &macros, const std::bitset<ConfigImage::BackButtons> &hasMacro,
+                              const int controllerType, ConfigImage &img, Diagnostics &diag) {
+        for (int num=1; num<=ConfigImage::BackButtons; ++num) {
+            Macro macro;
+            std::string error;
+
+            if (!hasMacro.test(num - 1))
+                continue;
+
+            if (!MacroCompiler::compile(macros[num - 1], controllerType, macro, error)) {
+                diag.error(std::format("{}_MACRO: {}", BackButtonNames[num - 1], error));
+                continue;
+            }
+
+            if (diag.isPedantic() && img.present.test(ConfigImage::fieldBackButton(num, 1, ConfigImage::SlotField::Key)))
+                diag.warning(std::format("{0}_MACRO replaces the {0} slot keys", BackButtonNames[num - 1]));
+
+            macro.fill(num, controllerType, img);
+        }
+    }
+
+    // pedantic only, import skips these silently
+    [[nodiscard]]
+    static bool isApplicable(const std::string_view key, const int keyType, const int mappingType, Diagnostics &diag) {
+        if (keyType == 0 || keyType == mappingType)
+            return true;
+
+        if (diag.isPedantic())
+            diag.warning(std::format("{} does not apply to V{} profiles, ignored", key, mappingType));
+
+        return false;
+    }
+
+    static void checkActiveSlots(const std::string_view key, const int field, const int value, Diagnostics &diag) {
+        if (diag.isPedantic() && field >= ConfigImage::fieldActiveSlots(1) && (value < 0 || value > ConfigImage::Slots))
+            diag.warning(std::format("{} must be in [0, {}], clamped", key, ConfigImage::Slots));
+    }
+
+    // controller type of a flat profile, so that convert knows which keys apply before reading them
+    [[nodiscard]]
+    static int peekMappingType(std::string_view data) {
+        constexpr std::string_view key = "MAPPING_TYPE:";
+        std::string_view value;
+        int mappingType;
+
+        while (!data.empty()) {
+            const char *eol = static_cast<const char *>(std::memchr(data.data(), '\n', data.size()));
+            const size_t len = eol ? eol - data.data() : data.size();
+            const std::string_view line = data.substr(0, len);
+
+            data.remove_prefix(eol ? len + 1 : len);
+
+            if (line.starts_with(key) && parseScalar(line.substr(key.size()), value) && parseInt(value, mappingType))
+                return mappingType;
+        }
+
+        return -1;
+    }
+
+    ProfileReader::Result ProfileReader::load(const std::string_view data, const int controllerType, ConfigImage &img, Diagnostics &diag) {
+        Diagnostics scratch (true, diag.isPedantic());
+        Result ret;
+
+        if (BinaryProfile::isBinary(data)) {
+            if (!BinaryProfile::decode(data, img, diag))
+                return Result::Error;
+
+            return controllerType == 0 || checkMappingType(img.controllerType, controllerType, diag) ? Result::Ok : Result::Error;
+        }
+
+        // yaml-cpp reports again what the streaming pass found before giving up, keep those only if its result is used
+        ret = parse(data, controllerType == 0 ? peekMappingType(data) : controllerType, img, scratch);
+        if (ret == Result::Unsupported)
+            return readYaml(YAML::Load(std::string(data)), controllerType, img, diag);
+
+        diag.merge(scratch);
+        return ret;
+    }
+
+    ProfileReader::Result ProfileReader::read(const std::string &fileName, const int controllerType, ConfigImage &img, Diagnostics &diag) {
+        const TraceSpan span ("readProfile");
+
+#ifdef __linux__
+        const int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st {};
+        void *data;
+        Result ret;
+
+        // let yaml-cpp report missing files
+        if (fd == -1)
+            return readYaml(YAML::LoadFile(fileName), controllerType, img, diag);
+
+        if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+            close(fd);
+            return readYaml(YAML::LoadFile(fileName), controllerType, img, diag);
+        }
+
+        data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (data == MAP_FAILED)
+            return readYaml(YAML::LoadFile(fileName), controllerType, img, diag);
+
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+        ret = load(std::string_view(static_cast<const char *>(data), st.st_size), controllerType, img, diag);
+
+        munmap(data, st.st_size);
+        return ret;
+#else
+        std::ifstream ifs (fileName, std::ios::binary);
+        std::string data;
+
+        if (!ifs.is_open())
+            return readYaml(YAML::LoadFile(fileName), controllerType, img, diag);
+
+        data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        return load(data, controllerType, img, diag);
+#endif
+    }
+
+    ProfileReader::Result ProfileReader::readCopy(const std::string &fileName, const int controllerType, ConfigImage &img, Diagnostics &diag) {
+        const TraceSpan span ("readProfile");
+
+#ifdef __linux__
+        const int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st {};
+        std::string data;
+        ssize_t n;
+
+        if (fd == -1)
+            return readYaml(YAML::LoadFile(fileName), controllerType, img, diag);
+
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+            data.reserve(st.st_size);
+
+        // read until eof, a file truncated meanwhile just comes out short
+        for (char buf[16384];;) {
+            n = ::read(fd, buf, sizeof(buf));
+            if (n > 0)
+                data.append(buf, n);
+            else if (n == 0 || errno != EINTR)
+                break;
+        }
+
+        close(fd);
+
+        if (n == -1 || data.empty())
+            return readYaml(YAML::LoadFile(fileName), controllerType, img, diag);
+
+        return load(data, controllerType, img, diag);
+#else
+        return read(fileName, controllerType, img, diag);
+#endif
+    }
+
+    ProfileReader::Result ProfileReader::readYaml(const YAML::Node &yaml, const int controllerType, ConfigImage &img, Diagnostics &diag) {
+        const TraceSpan span ("yaml-cpp");
+        const ProfileIndex &index = getIndex();
+        std::bitset<ConfigImage::FieldCount> unresolved;
+        std::array<std::string, ConfigImage::BackButtons> macros;
+        std::bitset<ConfigImage::BackButtons> hasMacro;
+        std::vector<std::string_view> unknown;
+        ConfigImage tmp;
+        int mappingType;
+
+        if (!yaml.IsMap()) {
+            diag.error("invalid yaml file");
+            return Result::Error;
+        }
+
+        mappingType = yaml["MAPPING_TYPE"] ? yaml["MAPPING_TYPE"].as<int>() : -1;
+        if (!checkMappingType(mappingType, controllerType == 0 ? mappingType : controllerType, diag))
+            return Result::Error;
+
+        // one pass over the document entries, each key is resolved to its field through the index
+        for (const auto &it: yaml) {
+            const auto *entry = it.first.IsScalar() ? index.find(it.first.Scalar()) : nullptr;
+
+            if (!entry) {
+                unknown.emplace_back(it.first.IsScalar() ? std::string_view(it.first.Scalar()) : "(not a scalar)");
+                continue;
+
+            } else if (entry->field == MappingTypeField || !isApplicable(entry->name, entry->controllerType, mappingType, diag)) {
+                continue;
+
+            } else if (entry->field <= MacroField) {
+                macros[MacroField - entry->field] = it.second.as<std::string>();
+                hasMacro.set(MacroField - entry->field);
+                continue;
+            }
+
+            if (!isKeyField(entry->field)) {
+                const int val = it.second.as<int>();
+
+                checkActiveSlots(entry->name, entry->field, val, diag);
+                storeInt(tmp, entry->field, val);
+
+            } else if (!it.second.IsScalar() || !storeKey(tmp, entry->field, it.second.Scalar())) {
+                unresolved.set(entry->field);
+                continue;
+            }
+
+            tmp.present.set(entry->field);
+        }
+
+        reportUnresolved(unknown, unresolved, diag);
+        compileMacros(macros, hasMacro, mappingType, tmp, diag);
+
+        tmp.controllerType = mappingType;
+        img = std::move(tmp);
+        return Result::Ok;
+    }
+
+    ProfileReader::Result ProfileReader::parse(std::string_view data, const int controllerType, ConfigImage &img, Diagnostics &diag) {
+        const ProfileIndex &index = getIndex();
+        std::bitset<ConfigImage::FieldCount> seen;
+        std::bitset<ConfigImage::FieldCount> unresolved;
+        std::array<std::string, ConfigImage::BackButtons> macros;
+        std::bitset<ConfigImage::BackButtons> hasMacro;
+        std::vector<std::string_view> unknown;
+        ConfigImage tmp;
+        int mappingType = -1;
+        int count = 0;
+
+        while (!data.empty()) {
+            const char *eol = static_cast<const char *>(std::memchr(data.data(), '\n', data.size()));
+            const size_t len = eol ? eol - data.data() : data.size();
+            std::string_view line = data.substr(0, len);
+            std::string_view value;
+            size_t keyLen = 0;
+
+            data.remove_prefix(eol ? len + 1 : len);
+
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+
+            if (line.empty() || line.front() == '#')
+                continue;
+
+            if (isBlank(line.front())) {
+                // nested content
+                if (!trim(line).empty() && trim(line).front() != '#')
+                    return Result::Unsupported;
+
+                continue;
+            }
+
+            if (line == "---" && count == 0)
+                continue;
+
+            while (keyLen < line.size() && (std::isalnum(static_cast<unsigned char>(line[keyLen])) || line[keyLen] == '_'))
+                ++keyLen;
+
+            if (keyLen == 0 || keyLen == line.size() || line[keyLen] != ':' || (keyLen + 1 < line.size() && !isBlank(line[keyLen + 1])))
+                return Result::Unsupported;
+
+            if (!parseScalar(line.substr(keyLen + 1), value))
+                return Result::Unsupported;
+
+            ++count;
+
+            const auto *entry = index.find(line.substr(0, keyLen));
+            int val;
+
+            // reported once the whole document is known to be in the subset
+            if (!entry) {
+                unknown.push_back(line.substr(0, keyLen));
+                continue;
+            }
+
+            if (entry->field == MappingTypeField) {
+                if (mappingType != -1 || !parseInt(value, mappingType) || mappingType == -1)
+                    return Result::Unsupported;
+
+                continue;
+
+            } else if (entry->field <= MacroField) {
+                const int idx = MacroField - entry->field;
+
+                if (hasMacro.test(idx))
+                    return Result::Unsupported;
+
+                hasMacro.set(idx);
+                if (isApplicable(entry->name, entry->controllerType, controllerType, diag))
+                    macros[idx] = value;
+                else
+                    hasMacro.reset(idx);
+
+                continue;
+            }
+
+            // duplicate keys are up to yaml-cpp
+            if (seen.test(entry->field))
+                return Result::Unsupported;
+
+            seen.set(entry->field);
+
+            if (!isApplicable(entry->name, entry->controllerType, controllerType, diag))
+                continue;
+
+            if (!isKeyField(entry->field)) {
+                if (!parseInt(value, val))
+                    return Result::Unsupported;
+
+                checkActiveSlots(entry->name, entry->field, val, diag);
+                storeInt(tmp, entry->field, val);
+
+            } else if (!storeKey(tmp, entry->field, value)) {
+                unresolved.set(entry->field);
+                continue;
+            }
+
+            tmp.present.set(entry->field);
+        }
+
+        // not a mapping, let yaml-cpp tell what it is
+        if (count == 0)
+            return Result::Unsupported;
+
+        if (!checkMappingType(mappingType, controllerType, diag))
+            return Result::Error;
+
+        reportUnresolved(unknown, unresolved, diag);
+        compileMacros(macros, hasMacro, controllerType, tmp, diag);
+
+        tmp.controllerType = controllerType;
+        img = std::move(tmp);
+        return Result::Ok;
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "ConfigImage.h"
+#include "Diagnostics.h"
+
+namespace YAML {
+    class Node;
+}
+
+namespace OWC {
+    /*
+     * Profile loader for import and convert
+     *
+     * Binary profiles are detected by magic. Flat yaml as written by export is read by a streaming parser that accepts
+     * top level "KEY: value" lines with plain or simple quoted scalars and comments, anything else goes through yaml-cpp.
+     * controllerType 0 accepts any mapping type, the image gets the one from the file.
+     */
+    class ProfileReader final {
+    public:
+        enum struct Result: int {
+            Ok = 0,
+            Error,
+            Unsupported
+        };
+
+    private:
+        [[nodiscard]] static Result readYaml(const YAML::Node &yaml, int controllerType, ConfigImage &img, Diagnostics &diag);
+
+    public:
+        ProfileReader() = delete;
+
+        // throws YAML::Exception for documents yaml-cpp fails to load
+        [[nodiscard]] static Result read(const std::string &fileName, int controllerType, ConfigImage &img, Diagnostics &diag = Diagnostics::console());
+        // like read without mmap, for files that may be truncated while parsed (watch), a truncated mapping raises SIGBUS
+        [[nodiscard]] static Result readCopy(const std::string &fileName, int controllerType, ConfigImage &img, Diagnostics &diag = Diagnostics::console());
+        // profile already in memory, yaml or binary, throws like read
+        [[nodiscard]] static Result load(std::string_view data, int controllerType, ConfigImage &img, Diagnostics &diag = Diagnostics::console());
+        [[nodiscard]] static Result parse(std::string_view data, int controllerType, ConfigImage &img, Diagnostics &diag = Diagnostics::console());
+    };
+}
@@ -0,0 +1,212 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <format>
+
+#include "ProfileValidator.h"
+#include "JsonUtils.h"
+#include "../include/Options.h"
+#include "ProfileReader.h"
+#include "ProfileWriter.h"
+#include "Tracer.h"
+#include "../extern/yaml-cpp/include/yaml-cpp/yaml.h"
+
+namespace OWC {
+    static void appendJsonList(std::string &out, const std::vector<std::string> &list) {
+        out += '[';
+
+        for (size_t i=0,l=list.size(); i<l; ++i) {
+            if (i > 0)
+                out += ", ";
+
+            appendJsonString(out, list[i]);
+        }
+
+        out += ']';
+    }
+
+    void ProfileValidator::checkMappingType(const ConfigImage &img, Diagnostics &diag) {
+        if (img.controllerType != 1 && img.controllerType != 2)
+            diag.error(std::format("unsupported MAPPING_TYPE {}, must be 1 or 2", img.controllerType));
+    }
+
+    void ProfileValidator::checkSlots(const ConfigImage &img, Diagnostics &diag) {
+        const int buttons = img.controllerType == 1 ? 2 : ConfigImage::BackButtons;
+        const int slots = img.controllerType == 1 ? 4 : ConfigImage::Slots;
+
+        for (int num=1; num<=buttons; ++num) {
+            const std::string_view btn = BackButtonNames[num - 1];
+            int keys = 0;
+
+            for (int slot=1; slot<=slots; ++slot) {
+                const std::array<std::pair<ConfigImage::SlotField, int>, 2> times = {{
+                    {ConfigImage::SlotField::StartTime, img.backButtonStartTimes[num - 1][slot - 1]},
+                    {ConfigImage::SlotField::HoldTime, img.backButtonHoldTimes[num - 1][slot - 1]}
+                }};
+
+                for (const auto &[field, time]: times) {
+                    const std::string_view label = field == ConfigImage::SlotField::StartTime ? "start" : "hold";
+
+                    if (!img.present.test(ConfigImage::fieldBackButton(num, slot, field)))
+                        continue;
+                    else if (time < 0)
+                        diag.error(std::format("{} slot {} {} time {} is negative", btn, slot, label, time));
+                    else if (time > MaxSlotTime)
+                        diag.warning(std::format("{} slot {} {} time {} is above {}", btn, slot, label, time, MaxSlotTime));
+                }
+
+                // slots are played in order up to the first unset key
+                if (keys == slot - 1 && img.present.test(ConfigImage::fieldBackButton(num, slot, ConfigImage::SlotField::Key)) && img.backButtonKeys[num - 1][slot - 1] != "UNSET")
+                    ++keys;
+            }
+
+            if (img.controllerType == 2 && img.present.test(ConfigImage::fieldActiveSlots(num)) && img.activeSlots[num - 1] > keys)
+                diag.warning(std::format("{}_ACTIVE_SLOTS is {}, but only {} slots have a key", btn, img.activeSlots[num - 1], keys));
+        }
+    }
+
+    bool ProfileValidator::read(const std::string &fileName, ConfigImage &img, Diagnostics &diag) {
+        try {
+            return ProfileReader::read(fileName, 0, img, diag) == ProfileReader::Result::Ok;
+
+        } catch (const YAML::Exception &yex) {
+            diag.error(std::format("failed to parse yaml: {}", yex.msg));
+            return false;
+        }
+    }
+
+    void ProfileValidator::finish(ProfileResult &result, const Diagnostics &diag) {
+        result.errors = diag.getErrors();
+        result.warnings = diag.getWarnings();
+    }
+
+    bool ProfileValidator::isProfileName(const std::string &fileName) {
+        const std::filesystem::path ext = std::filesystem::path(fileName).extension();
+
+        return ext == ".yaml" || ext == ".yml" || ext == ".owcb";
+    }
+
+    std::vector<std::string> ProfileValidator::collect(const std::vector<std::string> &paths) {
+        std::vector<std::string> files;
+
+        for (const std::string &path: paths) {
+            const std::filesystem::recursive_directory_iterator end;
+            std::error_code ec;
+            size_t first;
+
+            if (!std::filesystem::is_directory(path, ec)) {
+                files.push_back(path);
+                continue;
+            }
+
+            first = files.size();
+            for (auto it = std::filesystem::recursive_directory_iterator(path, std::filesystem::directory_options::skip_permission_denied, ec); !ec && it != end; it.increment(ec)) {
+                if (it->is_regular_file(ec) && isProfileName(it->path().string()))
+                    files.push_back(it->path().string());
+            }
+
+            std::sort(files.begin() + first, files.end());
+        }
+
+        return files;
+    }
+
+    ProfileResult ProfileValidator::validate(const std::string &fileName) {
+        const TraceSpan span ("validateProfile");
+        Diagnostics diag (true, true);
+        ProfileResult result;
+        ConfigImage img;
+
+        result.path = fileName;
+
+        if (read(fileName, img, diag)) {
+            result.mappingType = img.controllerType;
+
+            checkMappingType(img, diag);
+            checkSlots(img, diag);
+        }
+
+        finish(result, diag);
+        return result;
+    }
+
+    ProfileResult ProfileValidator::convert(const std::string &inFile, const std::string &outFile, const bool sync) {
+        const TraceSpan span ("convertProfile");
+        Diagnostics diag (true, false);
+        ProfileResult result;
+        ConfigImage img;
+
+        result.path = inFile;
+        result.output = outFile;
+
+        if (read(inFile, img, diag)) {
+            result.mappingType = img.controllerType;
+
+            checkMappingType(img, diag);
+            if (diag.getErrors().empty() && !ProfileWriter::write(img, outFile, sync, diag) && diag.getErrors().empty())
+                diag.error(std::format("failed to write {}", outFile));
+        }
+
+        finish(result, diag);
+        return result;
+    }
+
+    std::string_view ProfileValidator::status(const ProfileResult &result) {
+        if (!result.errors.empty())
+            return "error";
+        else if (!result.warnings.empty())
+            return "warning";
+
+        return "ok";
+    }
+
+    std::string ProfileValidator::toJson(const std::vector<ProfileResult> &results) {
+        std::array<int, 3> counts {};
+        std::string out;
+
+        out += "{\n  \"files\": [";
+
+        for (size_t i=0,l=results.size(); i<l; ++i) {
+            const ProfileResult &res = results[i];
+            const std::string_view st = status(res);
+
+            out += i > 0 ? ",\n    {\"path\": " : "\n    {\"path\": ";
+            appendJsonString(out, res.path);
+
+            if (!res.output.empty()) {
+                out += ", \"output\": ";
+                appendJsonString(out, res.output);
+            }
+
+            std::format_to(std::back_inserter(out), ", \"status\": \"{}\", \"mappingType\": {}, \"errors\": ", st, res.mappingType);
+            appendJsonList(out, res.errors);
+            out += ", \"warnings\": ";
+            appendJsonList(out, res.warnings);
+            out += '}';
+
+            ++counts[st == "ok" ? 0 : (st == "warning" ? 1 : 2)];
+        }
+
+        std::format_to(std::back_inserter(out), "\n  ],\n  \"summary\": {{\"files\": {}, \"ok\": {}, \"warning\": {}, \"error\": {}}}\n}}\n",
+            results.size(), counts[0], counts[1], counts[2]);
+
+        return out;
+    }
+}
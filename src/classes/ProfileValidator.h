@@ -0,0 +1,63 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ConfigImage.h"
+#include "Diagnostics.h"
+
+namespace OWC {
+    struct ProfileResult final {
+        std::string path;
+        std::string output; // convert target, empty for validate
+        int mappingType = -1;
+        std::vector<std::string> errors;
+        std::vector<std::string> warnings;
+    };
+
+    /*
+     * Offline checks for validate and directory convert, no device is opened
+     *
+     * Profiles are read pedantically with any mapping type, then checked for what import would reject or silently change.
+     * Every call only touches its own result, so files can be processed on WorkPool threads.
+     */
+    class ProfileValidator final {
+    private:
+        // assumed firmware limit, slot times are 16 bit milliseconds
+        static constexpr int MaxSlotTime = 65535;
+
+        static void checkMappingType(const ConfigImage &img, Diagnostics &diag);
+        static void checkSlots(const ConfigImage &img, Diagnostics &diag);
+        [[nodiscard]] static bool read(const std::string &fileName, ConfigImage &img, Diagnostics &diag);
+        static void finish(ProfileResult &result, const Diagnostics &diag);
+
+    public:
+        ProfileValidator() = delete;
+
+        [[nodiscard]] static bool isProfileName(const std::string &fileName);
+        // files are taken as given, directories are searched recursively for .yaml, .yml and .owcb, sorted
+        [[nodiscard]] static std::vector<std::string> collect(const std::vector<std::string> &paths);
+        [[nodiscard]] static ProfileResult validate(const std::string &fileName);
+        [[nodiscard]] static ProfileResult convert(const std::string &inFile, const std::string &outFile, bool sync);
+        [[nodiscard]] static std::string_view status(const ProfileResult &result);
+        [[nodiscard]] static std::string toJson(const std::vector<ProfileResult> &results);
+    };
+}
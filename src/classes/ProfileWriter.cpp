@@ -0,0 +1,271 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <format>
+#include <array>
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ProfileWriter.h"
+#include "../include/Options.h"
+#include "BinaryProfile.h"
+
+namespace OWC {
+    static void formatBackButtonsV1Yaml(const ConfigImage &img, std::string &out) {
+        for (int num=1; num<=2; ++num) {
+            const std::string_view btn = BackButtonNames[num - 1];
+
+            for (int i=1; i<=4; ++i) {
+                if (img.present.test(ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::Key)))
+                    std::format_to(std::back_inserter(out), "{}_K{}: {}\n", btn, i, img.backButtonKeys[num - 1][i - 1]);
+
+                if (i < 4 && img.present.test(ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::StartTime)))
+                    std::format_to(std::back_inserter(out), "{}_K{}_START_TIME: {}\n", btn, i, img.backButtonStartTimes[num - 1][i - 1]);
+            }
+        }
+
+        // the 4th start time slot is the whole macro start time
+        for (int num=1; num<=2; ++num) {
+            if (img.present.test(ConfigImage::fieldBackButton(num, 4, ConfigImage::SlotField::StartTime)))
+                std::format_to(std::back_inserter(out), "{}_MACRO_START_TIME: {}\n", BackButtonNames[num - 1], img.backButtonStartTimes[num - 1][3]);
+        }
+    }
+
+    static void formatBackButtonsV2Yaml(const ConfigImage &img, std::string &out) {
+        for (int num=1; num<=ConfigImage::BackButtons; ++num) {
+            const std::string_view btn = BackButtonNames[num - 1];
+
+            for (int i=1; i<=ConfigImage::Slots; ++i) {
+                if (img.present.test(ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::Key)))
+                    std::format_to(std::back_inserter(out), "{}_K{}: {}\n", btn, i, img.backButtonKeys[num - 1][i - 1]);
+
+                if (img.present.test(ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::StartTime)))
+                    std::format_to(std::back_inserter(out), "{}_K{}_START_TIME: {}\n", btn, i, img.backButtonStartTimes[num - 1][i - 1]);
+
+                if (img.present.test(ConfigImage::fieldBackButton(num, i, ConfigImage::SlotField::HoldTime)))
+                    std::format_to(std::back_inserter(out), "{}_K{}_HOLD_TIME: {}\n", btn, i, img.backButtonHoldTimes[num - 1][i - 1]);
+            }
+
+            if (img.present.test(ConfigImage::fieldActiveSlots(num)))
+                std::format_to(std::back_inserter(out), "{}_ACTIVE_SLOTS: {}\n", btn, img.activeSlots[num - 1]);
+        }
+    }
+
+#ifdef __linux__
+    [[nodiscard]]
+    static bool writeAll(const int fd, const std::string_view data) {
+        const char *p = data.data();
+        size_t len = data.size();
+
+        while (len > 0) {
+            const ssize_t ret = ::write(fd, p, len);
+
+            if (ret == -1 && errno == EINTR)
+                continue;
+            else if (ret <= 0)
+                return false;
+
+            p += ret;
+            len -= ret;
+        }
+
+        return true;
+    }
+#endif
+
+    bool ProfileWriter::writeDirect(const std::string &fileName, const std::string_view data, Diagnostics &diag) {
+#ifdef __linux__
+        const int fd = open(fileName.c_str(), O_WRONLY | O_CLOEXEC);
+        bool ok;
+
+        if (fd == -1) {
+            diag.error(std::format("failed to open {} for write: {}", fileName, std::strerror(errno)));
+            return false;
+        }
+
+        ok = writeAll(fd, data);
+        ok = close(fd) == 0 && ok;
+#else
+        std::ofstream ofs (fileName, std::ios::binary);
+        bool ok;
+
+        if (!ofs.is_open()) {
+            diag.error(std::format("failed to open {} for write", fileName));
+            return false;
+        }
+
+        ofs.write(data.data(), data.size());
+        ofs.close();
+        ok = !ofs.fail();
+#endif
+
+        if (!ok)
+            diag.error(std::format("failed to write {}", fileName));
+
+        return ok;
+    }
+
+    bool ProfileWriter::isBinaryName(const std::string &fileName) {
+        return std::filesystem::path(fileName).extension() == ".owcb";
+    }
+
+    void ProfileWriter::formatYaml(const ConfigImage &img, std::string &out) {
+        // a full V2 profile is ~10KB
+        out.reserve(out.size() + 12288);
+
+        std::format_to(std::back_inserter(out), "MAPPING_TYPE: {}\n", img.controllerType);
+
+        // keyboard&mouse mapping
+        for (int i=0; i<ConfigImage::KbmFields; ++i) {
+            if (img.present.test(ConfigImage::fieldKbm(i)))
+                std::format_to(std::back_inserter(out), "{}: {}\n", ConfigImage::KbmButtons[i].first, img.kbm[i]);
+        }
+
+        for (int i=0; i<ConfigImage::XinputFields; ++i) {
+            if (img.present.test(ConfigImage::fieldXinput(i)))
+                std::format_to(std::back_inserter(out), "{}: {}\n", ConfigImage::XinputButtons[i].first, img.xinput[i]);
+        }
+
+        if (img.controllerType == 1)
+            formatBackButtonsV1Yaml(img, out);
+        else if (img.controllerType == 2)
+            formatBackButtonsV2Yaml(img, out);
+    }
+
+    bool ProfileWriter::writeAtomic(const std::string &fileName, const std::string_view data, const bool sync, Diagnostics &diag) {
+        std::filesystem::path target = fileName;
+        std::filesystem::path tmpFile;
+        std::error_code ec;
+
+        // replace the link target, not the link
+        if (std::filesystem::is_symlink(target, ec))
+            target = std::filesystem::weakly_canonical(target, ec);
+
+        tmpFile = target;
+
+#ifdef __linux__
+        struct stat st {};
+        bool ok;
+        int fd;
+
+        // devices, fifos and /proc/self/fd links cannot be replaced, write to them in place
+        if (stat(fileName.c_str(), &st) == 0 && !S_ISREG(st.st_mode))
+            return writeDirect(fileName, data, diag);
+
+        tmpFile += std::format(".{}.tmp", getpid());
+
+        fd = open(tmpFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (fd == -1) {
+            diag.error(std::format("failed to open {} for write: {}", fileName, std::strerror(errno)));
+            return false;
+        }
+
+        // keep the permissions of the profile being replaced
+        if (st.st_mode != 0)
+            fchmod(fd, st.st_mode & 07777);
+
+        ok = writeAll(fd, data) && (!sync || fsync(fd) == 0);
+        ok = close(fd) == 0 && ok;
+
+        if (!ok) {
+            diag.error(std::format("failed to write {}: {}", fileName, std::strerror(errno)));
+            unlink(tmpFile.c_str());
+            return false;
+        }
+
+        if (rename(tmpFile.c_str(), target.c_str()) == -1) {
+            diag.error(std::format("failed to replace {}: {}", fileName, std::strerror(errno)));
+            unlink(tmpFile.c_str());
+            return false;
+        }
+
+        // make the rename itself durable
+        if (sync) {
+            const std::filesystem::path dir = target.has_parent_path() ? target.parent_path() : ".";
+            const int dirFd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+            if (dirFd != -1) {
+                fsync(dirFd);
+                close(dirFd);
+            }
+        }
+
+        return true;
+#else
+        if (std::filesystem::exists(target, ec) && !std::filesystem::is_regular_file(target, ec))
+            return writeDirect(fileName, data, diag);
+
+        tmpFile += ".tmp";
+
+        std::ofstream ofs (tmpFile, std::ios::binary | std::ios::trunc);
+
+        if (!ofs.is_open()) {
+            diag.error(std::format("failed to open {} for write", fileName));
+            return false;
+        }
+
+        ofs.write(data.data(), data.size());
+        if (sync)
+            ofs.flush();
+
+        ofs.close();
+        if (ofs.fail()) {
+            diag.error(std::format("failed to write {}", fileName));
+            std::filesystem::remove(tmpFile, ec);
+            return false;
+        }
+
+        std::filesystem::rename(tmpFile, target, ec);
+        if (ec) {
+            diag.error(std::format("failed to replace {}: {}", fileName, ec.message()));
+            std::filesystem::remove(tmpFile, ec);
+            return false;
+        }
+
+        return true;
+#endif
+    }
+
+    bool ProfileWriter::write(const ConfigImage &img, const std::string &fileName, const bool sync, Diagnostics &diag) {
+        std::string data;
+
+        if (fileName == "-") {
+            formatYaml(img, data);
+            std::cout.write(data.data(), data.size());
+            std::cout.flush();
+            return !std::cout.fail();
+        }
+
+        if (isBinaryName(fileName)) {
+            if (!BinaryProfile::encode(img, data, diag))
+                return false;
+
+        } else {
+            formatYaml(img, data);
+        }
+
+        return writeAtomic(fileName, data, sync, diag);
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "ConfigImage.h"
+#include "Diagnostics.h"
+
+namespace OWC {
+    /*
+     * Profile writer for export and convert
+     *
+     * Only mapping and back button fields are written, files ending in .owcb get the binary format, anything else yaml.
+     * The profile is serialized in memory and replaces the target atomically, - writes yaml to stdout.
+     * Targets that are not regular files (devices, fifos) are written in place.
+     */
+    class ProfileWriter final {
+    private:
+        [[nodiscard]] static bool writeDirect(const std::string &fileName, std::string_view data, Diagnostics &diag);
+        [[nodiscard]] static bool writeAtomic(const std::string &fileName, std::string_view data, bool sync, Diagnostics &diag);
+
+    public:
+        ProfileWriter() = delete;
+
+        [[nodiscard]] static bool isBinaryName(const std::string &fileName);
+        [[nodiscard]] static bool write(const ConfigImage &img, const std::string &fileName, bool sync = false, Diagnostics &diag = Diagnostics::console());
+        static void formatYaml(const ConfigImage &img, std::string &out);
+    };
+}
@@ -0,0 +1,132 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+
+#include "SwitchRules.h"
+
+namespace OWC {
+    [[nodiscard]]
+    static std::string_view trim(std::string_view str) {
+        while (!str.empty() && std::isspace(static_cast<unsigned char>(str.front())))
+            str.remove_prefix(1);
+
+        while (!str.empty() && std::isspace(static_cast<unsigned char>(str.back())))
+            str.remove_suffix(1);
+
+        return str;
+    }
+
+    [[nodiscard]]
+    static bool equalsNoCase(const std::string_view a, const std::string_view b) {
+        return std::ranges::equal(a, b, [](const unsigned char ca, const unsigned char cb) { return std::tolower(ca) == std::tolower(cb); });
+    }
+
+    bool SwitchRules::parseLine(std::string_view line, const int lineNum, const std::string &baseDir) {
+        std::string_view rule, kind, pattern, profile;
+        std::filesystem::path profilePath;
+        size_t pos;
+
+        line = trim(line);
+        if (line.empty() || line.starts_with('#'))
+            return true;
+
+        // the pattern may contain anything, so split at the last arrow
+        pos = line.rfind("->");
+        if (pos == std::string_view::npos) {
+            std::cerr << "line " << lineNum << ": expected rule -> profile\n";
+            return false;
+        }
+
+        rule = trim(line.substr(0, pos));
+        profile = trim(line.substr(pos + 2));
+        pos = std::min(rule.find_first_of(" \t"), rule.size());
+        kind = rule.substr(0, pos);
+        pattern = trim(rule.substr(pos));
+
+        if (profile.empty()) {
+            std::cerr << "line " << lineNum << ": missing profile\n";
+            return false;
+        }
+
+        profilePath = profile;
+        if (profilePath.is_relative())
+            profilePath = std::filesystem::path(baseDir) / profilePath;
+
+        if (kind == "default") {
+            defaultProfile = profilePath.string();
+            return true;
+
+        } else if ((kind != "exe" && kind != "cmdline") || pattern.empty()) {
+            std::cerr << "line " << lineNum << ": expected exe name, cmdline regex or default\n";
+            return false;
+        }
+
+        SwitchRule &sr = rules.emplace_back(lineNum, kind == "cmdline", std::string(pattern), std::regex(), profilePath.string());
+
+        if (sr.cmdline) {
+            try {
+                sr.regex = std::regex(sr.pattern, std::regex::ECMAScript | std::regex::optimize);
+
+            } catch (const std::regex_error &rex) {
+                std::cerr << "line " << lineNum << ": invalid regex: " << rex.what() << "\n";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool SwitchRules::load(const std::string &fileName) {
+        const std::filesystem::path path = fileName;
+        std::ifstream file (fileName);
+        std::string line;
+        int lineNum = 0;
+
+        if (!file.is_open()) {
+            std::cerr << "failed to open " << fileName << "\n";
+            return false;
+        }
+
+        while (std::getline(file, line)) {
+            if (!parseLine(line, ++lineNum, path.has_parent_path() ? path.parent_path().string() : "."))
+                return false;
+        }
+
+        if (rules.empty()) {
+            std::cerr << "no rules in " << fileName << "\n";
+            return false;
+        }
+
+        return true;
+    }
+
+    int SwitchRules::match(const std::string_view exe, const std::string &cmdline) const {
+        for (int i=0,l=rules.size(); i<l; ++i) {
+            const SwitchRule &rule = rules[i];
+
+            if (rule.cmdline ? std::regex_search(cmdline, rule.regex) : equalsNoCase(rule.pattern, exe))
+                return i;
+        }
+
+        return -1;
+    }
+}
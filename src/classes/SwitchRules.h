@@ -0,0 +1,57 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace OWC {
+    struct SwitchRule final {
+        int line;
+        bool cmdline; // regex on the command line, else exe name
+        std::string pattern;
+        std::regex regex;
+        std::string profile;
+    };
+
+    /*
+     * Rules for autoswitch, one per line, first match wins:
+     *
+     *   exe eldenring.exe -> elden.yaml
+     *   cmdline \bhl2\.exe\b -> hl2.owcb
+     *   default -> base.yaml
+     *
+     * Exe names are compared case-insensitively, profile paths are relative to the rules file.
+     */
+    class SwitchRules final {
+    private:
+        std::vector<SwitchRule> rules;
+        std::string defaultProfile;
+
+        [[nodiscard]] bool parseLine(std::string_view line, int lineNum, const std::string &baseDir);
+
+    public:
+        [[nodiscard]] bool load(const std::string &fileName);
+        // rule index, -1 if none matches
+        [[nodiscard]] int match(std::string_view exe, const std::string &cmdline) const;
+        [[nodiscard]] const std::vector<SwitchRule> &getRules() const { return rules; }
+        [[nodiscard]] const std::string &getDefault() const { return defaultProfile; }
+    };
+}
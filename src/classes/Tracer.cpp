@@ -0,0 +1,184 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <string_view>
+
+#include "Tracer.h"
+#include "JsonUtils.h"
+#include "../version.h"
+
+namespace OWC {
+    static thread_local int spanDepth = 0;
+
+    [[nodiscard]]
+    static int threadId() {
+        static std::atomic_int nextId = 1;
+        static thread_local const int id = nextId++;
+
+        return id;
+    }
+
+    Tracer *Tracer::getInstance() {
+        if (!instance)
+            instance = new Tracer();
+
+        return instance;
+    }
+
+    void Tracer::init(const std::string &traceFile, const bool timings) {
+        const std::lock_guard guard (lock);
+
+        events.clear();
+        meta.clear();
+        this->traceFile = traceFile;
+        this->timings = timings;
+        // ids follow the first span each thread ends, a worker can end one before the main thread does
+        mainTid = threadId();
+        enabled = !traceFile.empty() || timings;
+    }
+
+    void Tracer::setMeta(std::string key, std::string value) {
+        const std::lock_guard guard (lock);
+
+        if (enabled)
+            meta.emplace_back(std::move(key), std::move(value));
+    }
+
+    void Tracer::add(const char *name, const std::chrono::steady_clock::time_point start, const std::chrono::steady_clock::time_point end, const int depth) {
+        const std::lock_guard guard (lock);
+
+        if (!enabled)
+            return;
+
+        events.emplace_back(name, std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin).count(),
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(), threadId(), depth);
+    }
+
+    bool Tracer::writeTrace() {
+        std::ofstream ofs;
+        std::string out;
+
+        out.reserve(events.size() * 96 + 256);
+        out += "{\"displayTimeUnit\": \"ms\", \"otherData\": {";
+
+        for (size_t i=0,l=meta.size(); i<l; ++i) {
+            out += i > 0 ? ", " : "";
+            appendJsonString(out, meta[i].first);
+            out += ": ";
+            appendJsonString(out, meta[i].second);
+        }
+
+        out += "},\n\"traceEvents\": [\n";
+        std::format_to(std::back_inserter(out), "{{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {{\"name\": \"{}\"}}}}", APP_NAME);
+
+        // ts and dur are in microseconds
+        for (const Event &ev: events) {
+            std::format_to(std::back_inserter(out), ",\n{{\"name\": \"{}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, \"ts\": {:.3f}, \"dur\": {:.3f}}}",
+                ev.name, ev.tid, ev.start / 1000.0, ev.dur / 1000.0);
+        }
+
+        out += "\n]}\n";
+
+        ofs.open(traceFile, std::ios::trunc);
+        ofs << out;
+        ofs.close();
+
+        if (ofs.fail()) {
+            std::cerr << "failed to write trace " << traceFile << "\n";
+            return false;
+        }
+
+        return true;
+    }
+
+    void Tracer::printTimings() {
+        struct Stage final {
+            const char *name;
+            int depth;
+            int calls;
+            int64_t total;
+        };
+        std::vector<Stage> stages;
+        std::string out = "timings (ms):\n";
+
+        // main thread only, worker spans would repeat per file
+        for (const Event &ev: events) {
+            if (ev.tid != mainTid)
+                continue;
+
+            const auto it = std::ranges::find_if(stages, [&ev](const Stage &st) { return std::string_view(st.name) == ev.name && st.depth == ev.depth; });
+
+            if (it == stages.end()) {
+                stages.emplace_back(ev.name, ev.depth, 1, ev.dur);
+
+            } else {
+                ++it->calls;
+                it->total += ev.dur;
+            }
+        }
+
+        for (const Stage &st: stages) {
+            std::format_to(std::back_inserter(out), "  {:{}}{:<{}}{:>10.3f}", "", st.depth * 2, st.name, 28 - st.depth * 2, st.total / 1e6);
+            out += st.calls > 1 ? std::format("  x{}\n", st.calls) : "\n";
+        }
+
+        std::cerr << out;
+    }
+
+    bool Tracer::finish() {
+        const std::lock_guard guard (lock);
+        bool ret = true;
+
+        if (!enabled)
+            return true;
+
+        enabled = false;
+
+        // spans are recorded when they end, children before parents
+        std::ranges::stable_sort(events, {}, &Event::start);
+
+        if (!traceFile.empty())
+            ret = writeTrace();
+
+        if (timings)
+            printTimings();
+
+        events.clear();
+        return ret;
+    }
+
+    TraceSpan::TraceSpan(const char *name): name(name) {
+        if (!Tracer::isEnabled())
+            return;
+
+        depth = spanDepth++;
+        start = std::chrono::steady_clock::now();
+    }
+
+    TraceSpan::~TraceSpan() {
+        if (depth == -1)
+            return;
+
+        --spanDepth;
+        Tracer::getInstance()->add(name, start, std::chrono::steady_clock::now(), depth);
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace OWC {
+    /*
+     * Stage timings for --trace (Chrome/Perfetto trace event json) and --timings (summary on stderr)
+     *
+     * Spans are recorded with TraceSpan, nesting follows scope. Nothing is measured unless one of the options is given.
+     */
+    class Tracer final {
+    private:
+        struct Event final {
+            const char *name;
+            int64_t start; // ns since origin
+            int64_t dur;
+            int tid;
+            int depth;
+        };
+
+        static inline Tracer *instance = nullptr;
+        static inline std::atomic_bool enabled = false;
+        const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+        std::vector<Event> events;
+        std::vector<std::pair<std::string, std::string>> meta;
+        std::mutex lock;
+        std::string traceFile;
+        bool timings = false;
+        int mainTid = 1;
+
+        Tracer() = default;
+
+        [[nodiscard]] bool writeTrace();
+        void printTimings();
+
+    public:
+        Tracer(Tracer &) = delete;
+
+        static Tracer *getInstance();
+        [[nodiscard]] static bool isEnabled() { return enabled; }
+        // main thread only, its spans are the --timings summary
+        void init(const std::string &traceFile, bool timings);
+        // shown in the trace metadata, firmware version and board
+        void setMeta(std::string key, std::string value);
+        void add(const char *name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end, int depth);
+        // writes the trace and prints the summary, then stops recording
+        [[nodiscard]] bool finish();
+    };
+
+    class TraceSpan final {
+    private:
+        const char *name;
+        std::chrono::steady_clock::time_point start;
+        int depth = -1;
+
+    public:
+        // name must be a string literal
+        explicit TraceSpan(const char *name);
+        TraceSpan(TraceSpan &) = delete;
+
+        ~TraceSpan();
+    };
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <thread>
+
+#include "WorkPool.h"
+
+namespace OWC {
+    bool WorkPool::pop(Queue &queue, size_t &idx) {
+        const std::lock_guard lock (queue.lock);
+
+        if (queue.items.empty())
+            return false;
+
+        idx = queue.items.front();
+        queue.items.pop_front();
+        return true;
+    }
+
+    bool WorkPool::steal(std::vector<Queue> &queues, const size_t self, size_t &idx) {
+        for (size_t i=1,l=queues.size(); i<l; ++i) {
+            Queue &victim = queues[(self + i) % l];
+            const std::lock_guard lock (victim.lock);
+
+            if (victim.items.empty())
+                continue;
+
+            idx = victim.items.back();
+            victim.items.pop_back();
+            return true;
+        }
+
+        return false;
+    }
+
+    unsigned WorkPool::defaultJobs() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    void WorkPool::run(const size_t count, unsigned jobs, const std::function<void(size_t)> &fn) {
+        jobs = std::clamp<size_t>(jobs, 1, std::max<size_t>(count, 1));
+
+        if (jobs == 1) {
+            for (size_t i=0; i<count; ++i)
+                fn(i);
+
+            return;
+        }
+
+        std::vector<Queue> queues (jobs);
+        std::vector<std::jthread> workers;
+
+        // no work is added once running, a worker is done when it finds nothing to steal
+        for (size_t i=0; i<count; ++i)
+            queues[i * jobs / count].items.push_back(i);
+
+        workers.reserve(jobs);
+        for (size_t w=0; w<jobs; ++w) {
+            workers.emplace_back([&queues, &fn, w] {
+                size_t idx;
+
+                while (pop(queues[w], idx) || steal(queues, w, idx))
+                    fn(idx);
+            });
+        }
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace OWC {
+    /*
+     * Work-stealing pool for offline bulk commands
+     *
+     * Each worker owns a queue seeded with a contiguous range of indices and takes from its front,
+     * idle workers steal from the back of the others, so a few slow files don't leave cores idle.
+     */
+    class WorkPool final {
+    private:
+        struct Queue final {
+            std::mutex lock;
+            std::deque<size_t> items;
+        };
+
+        [[nodiscard]] static bool pop(Queue &queue, size_t &idx);
+        [[nodiscard]] static bool steal(std::vector<Queue> &queues, size_t self, size_t &idx);
+
+    public:
+        WorkPool() = delete;
+
+        [[nodiscard]] static unsigned defaultJobs();
+        // fn is called once for every index in [0, count), from up to jobs threads
+        static void run(size_t count, unsigned jobs, const std::function<void(size_t)> &fn);
+    };
+}
@@ -0,0 +1,247 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "../extern/libOpenWinControls/src/controller/Controller.h"
+#include "../extern/libOpenWinControls/src/include/ControllerFeature.h"
+
+namespace OWC {
+    enum struct OptionType: int {
+        Key,
+        XinputKey,
+        KeyList,
+        TimeList,
+        Macro,
+        Int,
+        Color
+    };
+
+    enum struct OptionTarget: int {
+        Button,
+        BackButtonKeys,
+        BackButtonStartTimes,
+        BackButtonHoldTimes,
+        BackButtonActiveSlots,
+        BackButtonMacro,
+        Rumble,
+        LeftCenter,
+        LeftBoundary,
+        RightCenter,
+        RightBoundary,
+        LedMode,
+        LedColor
+    };
+
+    inline constexpr ControllerFeature NoFeature = static_cast<ControllerFeature>(0);
+
+    /*
+     * set options schema, drives parsing, validation, help and config dispatch
+     *
+     * controllerType: 0 = any, 1 = V1 only, 2 = V2 only
+     * minVal/maxVal: accepted range for Int and Color values
+     */
+    struct Option final {
+        std::string_view name;
+        OptionType type;
+        OptionTarget target;
+        Button button;
+        int backButton;
+        int controllerType;
+        ControllerFeature feature;
+        int minVal;
+        int maxVal;
+        std::string_view label;
+        std::string_view argHelp;
+        std::string_view help;
+    };
+
+    [[nodiscard]]
+    consteval Option keyOption(const std::string_view name, const Button btn, const std::string_view label, const std::string_view help) {
+        return {name, OptionType::Key, OptionTarget::Button, btn, 0, 0, NoFeature, 0, 0, label, "[key]", help};
+    }
+
+    [[nodiscard]]
+    consteval Option xkeyOption(const std::string_view name, const Button btn, const std::string_view label, const std::string_view help) {
+        return {name, OptionType::XinputKey, OptionTarget::Button, btn, 0, 0, ControllerFeature::XinputMappingV1, 0, 0, label, "[xinput button]", help};
+    }
+
+    [[nodiscard]]
+    consteval Option backButtonOption(const std::string_view name, const OptionType type, const OptionTarget target, const int num, const int controllerType,
+                                      const ControllerFeature feature, const std::string_view label, const std::string_view argHelp, const std::string_view help)
+    {
+        return {name, type, target, Button{}, num, controllerType, feature, 0, 32, label, argHelp, help};
+    }
+
+    [[nodiscard]]
+    consteval Option intOption(const std::string_view name, const OptionTarget target, const ControllerFeature feature, const int minVal, const int maxVal,
+                               const std::string_view label, const std::string_view argHelp, const std::string_view help)
+    {
+        return {name, OptionType::Int, target, Button{}, 0, 0, feature, minVal, maxVal, label, argHelp, help};
+    }
+
+    inline constexpr std::array Options = {
+        keyOption("du", Button::KBD_DPAD_UP, "dpad up", "Assign dpad up a key"),
+        keyOption("dd", Button::KBD_DPAD_DOWN, "dpad down", "Assign dpad down a key"),
+        keyOption("dl", Button::KBD_DPAD_LEFT, "dpad left", "Assign dpad left a key"),
+        keyOption("dr", Button::KBD_DPAD_RIGHT, "dpad right", "Assign dpad right a key"),
+        keyOption("a", Button::KBD_A, "A button", "Assign A button a key"),
+        keyOption("b", Button::KBD_B, "B button", "Assign B button a key"),
+        keyOption("x", Button::KBD_X, "X button", "Assign X button a key"),
+        keyOption("y", Button::KBD_Y, "Y button", "Assign Y button a key"),
+        keyOption("lu", Button::KBD_LANALOG_UP, "left analog up", "Assign left analog up a key"),
+        keyOption("ld", Button::KBD_LANALOG_DOWN, "left analog down", "Assign left analog down a key"),
+        keyOption("ll", Button::KBD_LANALOG_LEFT, "left analog left", "Assign left analog left a key"),
+        keyOption("lr", Button::KBD_LANALOG_RIGHT, "left analog right", "Assign left analog right a key"),
+        keyOption("st", Button::KBD_START, "start button", "Assign start button a key"),
+        keyOption("sl", Button::KBD_SELECT, "select button", "Assign select button a key"),
+        keyOption("mu", Button::KBD_MENU, "menu button", "Assign menu button a key"),
+        keyOption("l1", Button::KBD_L1, "L1 button", "Assign L1 button a key"),
+        keyOption("l2", Button::KBD_L2, "L2 button", "Assign L2 button a key"),
+        keyOption("l3", Button::KBD_L3, "L3 button", "Assign L3 button a key"),
+        keyOption("r1", Button::KBD_R1, "R1 button", "Assign R1 button a key"),
+        keyOption("r2", Button::KBD_R2, "R2 button", "Assign R2 button a key"),
+        keyOption("r3", Button::KBD_R3, "R3 button", "Assign R3 button a key"),
+        xkeyOption("xdu", Button::X_DPAD_UP, "xinput dpad up", "Reassign dpad up button"),
+        xkeyOption("xdd", Button::X_DPAD_DOWN, "xinput dpad down", "Reassign dpad down button"),
+        xkeyOption("xdl", Button::X_DPAD_LEFT, "xinput dpad left", "Reassign dpad left button"),
+        xkeyOption("xdr", Button::X_DPAD_RIGHT, "xinput dpad right", "Reassign dpad right button"),
+        xkeyOption("xa", Button::X_A, "xinput A button", "Reassign A button"),
+        xkeyOption("xb", Button::X_B, "xinput B button", "Reassign B button"),
+        xkeyOption("xx", Button::X_X, "xinput X button", "Reassign X button"),
+        xkeyOption("xy", Button::X_Y, "xinput Y button", "Reassign Y button"),
+        xkeyOption("xlu", Button::X_LANALOG_UP, "xinput left analog up", "Reassign left analog up button"),
+        xkeyOption("xld", Button::X_LANALOG_DOWN, "xinput left analog down", "Reassign left analog down button"),
+        xkeyOption("xll", Button::X_LANALOG_LEFT, "xinput left analog left", "Reassign left analog left button"),
+        xkeyOption("xlr", Button::X_LANALOG_RIGHT, "xinput left analog right", "Reassign left analog right button"),
+        xkeyOption("xru", Button::X_RANALOG_UP, "xinput right analog up", "Reassign right analog up button"),
+        xkeyOption("xrd", Button::X_RANALOG_DOWN, "xinput right analog down", "Reassign right analog down button"),
+        xkeyOption("xrl", Button::X_RANALOG_LEFT, "xinput right analog left", "Reassign right analog left button"),
+        xkeyOption("xrr", Button::X_RANALOG_RIGHT, "xinput right analog right", "Reassign right analog right button"),
+        xkeyOption("xst", Button::X_START, "xinput start button", "Reassign start button"),
+        xkeyOption("xsl", Button::X_SELECT, "xinput select button", "Reassign select button"),
+        xkeyOption("xmu", Button::X_MENU, "xinput menu button", "Reassign menu button"),
+        xkeyOption("xl1", Button::X_L1, "xinput L1 button", "Reassign L1 button"),
+        xkeyOption("xl2", Button::X_L2, "xinput L2 button", "Reassign L2 button"),
+        xkeyOption("xl3", Button::X_L3, "xinput L3 button", "Reassign L3 button"),
+        xkeyOption("xr1", Button::X_R1, "xinput R1 button", "Reassign R1 button"),
+        xkeyOption("xr2", Button::X_R2, "xinput R2 button", "Reassign R2 button"),
+        xkeyOption("xr3", Button::X_R3, "xinput R3 button", "Reassign R3 button"),
+        backButtonOption("l4", OptionType::KeyList, OptionTarget::BackButtonKeys, 1, 0, NoFeature, "L4", "[key1,key2,key3..]", "Comma separated list of keys\n    Assign L4 back button"),
+        backButtonOption("l4d", OptionType::TimeList, OptionTarget::BackButtonStartTimes, 1, 0, NoFeature, "L4 start times", "[time1,time2..]", "Comma separated list of times\n    Set L4 back button keys start time in milliseconds"),
+        backButtonOption("l4h", OptionType::TimeList, OptionTarget::BackButtonHoldTimes, 1, 2, NoFeature, "L4 hold times", "[time1,time2..]", "Comma separated list of times\n    Set L4 back button keys hold time in milliseconds"),
+        backButtonOption("l4n", OptionType::Int, OptionTarget::BackButtonActiveSlots, 1, 2, NoFeature, "L4 active slots", "[num]", "Manually override L4 macro active slots number [0, 32]"),
+        backButtonOption("l4m", OptionType::Macro, OptionTarget::BackButtonMacro, 1, 0, NoFeature, "L4 macro", "[macro]", "Compile a macro into the L4 slots, replaces l4, l4d and l4h, see Notes"),
+        backButtonOption("r4", OptionType::KeyList, OptionTarget::BackButtonKeys, 2, 0, NoFeature, "R4", "[key1,key2,key3..]", "Comma separated list of keys\n    Assign R4 back button"),
+        backButtonOption("r4d", OptionType::TimeList, OptionTarget::BackButtonStartTimes, 2, 0, NoFeature, "R4 start times", "[time1,time2..]", "Comma separated list of times\n    Set R4 back button keys start time in milliseconds"),
+        backButtonOption("r4h", OptionType::TimeList, OptionTarget::BackButtonHoldTimes, 2, 2, NoFeature, "R4 hold times", "[time1,time2..]", "Comma separated list of times\n    Set R4 back button keys hold time in milliseconds"),
+        backButtonOption("r4n", OptionType::Int, OptionTarget::BackButtonActiveSlots, 2, 2, NoFeature, "R4 active slots", "[num]", "Manually override R4 macro active slots number [0, 32]"),
+        backButtonOption("r4m", OptionType::Macro, OptionTarget::BackButtonMacro, 2, 0, NoFeature, "R4 macro", "[macro]", "Compile a macro into the R4 slots, replaces r4, r4d and r4h, see Notes"),
+        backButtonOption("l5", OptionType::KeyList, OptionTarget::BackButtonKeys, 3, 2, ControllerFeature::BackButton3, "L5", "[key1,key2,key3..]", "Comma separated list of keys\n    Assign L5 back button"),
+        backButtonOption("l5d", OptionType::TimeList, OptionTarget::BackButtonStartTimes, 3, 2, ControllerFeature::BackButton3, "L5 start times", "[time1,time2..]", "Comma separated list of times\n    Set L5 back button keys start time in milliseconds"),
+        backButtonOption("l5h", OptionType::TimeList, OptionTarget::BackButtonHoldTimes, 3, 2, ControllerFeature::BackButton3, "L5 hold times", "[time1,time2..]", "Comma separated list of times\n    Set L5 back button keys hold time in milliseconds"),
+        backButtonOption("l5n", OptionType::Int, OptionTarget::BackButtonActiveSlots, 3, 2, ControllerFeature::BackButton3, "L5 active slots", "[num]", "Manually override L5 macro active slots number [0, 32]"),
+        backButtonOption("l5m", OptionType::Macro, OptionTarget::BackButtonMacro, 3, 2, ControllerFeature::BackButton3, "L5 macro", "[macro]", "Compile a macro into the L5 slots, replaces l5, l5d and l5h, see Notes"),
+        backButtonOption("r5", OptionType::KeyList, OptionTarget::BackButtonKeys, 4, 2, ControllerFeature::BackButton4, "R5", "[key1,key2,key3..]", "Comma separated list of keys\n    Assign R5 back button"),
+        backButtonOption("r5d", OptionType::TimeList, OptionTarget::BackButtonStartTimes, 4, 2, ControllerFeature::BackButton4, "R5 start times", "[time1,time2..]", "Comma separated list of times\n    Set R5 back button keys start time in milliseconds"),
+        backButtonOption("r5h", OptionType::TimeList, OptionTarget::BackButtonHoldTimes, 4, 2, ControllerFeature::BackButton4, "R5 hold times", "[time1,time2..]", "Comma separated list of times\n    Set R5 back button keys hold time in milliseconds"),
+        backButtonOption("r5n", OptionType::Int, OptionTarget::BackButtonActiveSlots, 4, 2, ControllerFeature::BackButton4, "R5 active slots", "[num]", "Manually override R5 macro active slots number [0, 32]"),
+        backButtonOption("r5m", OptionType::Macro, OptionTarget::BackButtonMacro, 4, 2, ControllerFeature::BackButton4, "R5 macro", "[macro]", "Compile a macro into the R5 slots, replaces r5, r5d and r5h, see Notes"),
+        intOption("rmb", OptionTarget::Rumble, ControllerFeature::RumbleV1, 0, 2, "vibration intensity", "[mode]", "Set vibration intensity [0 = off, 1 = low, 2 = high]"),
+        intOption("lc", OptionTarget::LeftCenter, ControllerFeature::DeadZoneControlV1, -10, 10, "left analog deadzone", "[value]", "Adjust left analog deadzone [-10, +10]"),
+        intOption("lb", OptionTarget::LeftBoundary, ControllerFeature::DeadZoneControlV1, -10, 10, "left analog boundary", "[value]", "Adjust left analog boundary [-10, +10]"),
+        intOption("rc", OptionTarget::RightCenter, ControllerFeature::DeadZoneControlV1, -10, 10, "right analog deadzone", "[value]", "Adjust right analog deadzone [-10, +10]"),
+        intOption("rb", OptionTarget::RightBoundary, ControllerFeature::DeadZoneControlV1, -10, 10, "right analog boundary", "[value]", "Adjust right analog boundary [-10, +10]"),
+        intOption("led", OptionTarget::LedMode, ControllerFeature::ShoulderLedsV1, 0, 3, "led mode", "[mode]", "Set shoulder buttons led mode [0 = off, 1 = solid, 2 = breathe, 3 = rotate]"),
+        Option {"ledclr", OptionType::Color, OptionTarget::LedColor, Button{}, 0, 0, ControllerFeature::ShoulderLedsV1, 0, 255, "led color", "[R:G:B]", "Set shoulder buttons led color [0-255:0-255:0-255]"}
+    };
+
+    // FNV-1a with a seed, the seed is searched at compile time until no option names collide
+    [[nodiscard]]
+    constexpr uint32_t optionHash(const std::string_view str, const uint32_t seed) {
+        uint32_t hash = 2166136261u ^ seed;
+
+        for (const char c: str) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+
+        return hash;
+    }
+
+    struct OptionIndex final {
+        static constexpr size_t Size = 512;
+        static constexpr uint8_t Empty = 0xff;
+
+        uint32_t seed;
+        std::array<uint8_t, Size> slots;
+    };
+
+    static_assert(Options.size() < OptionIndex::Empty);
+
+    [[nodiscard]]
+    consteval OptionIndex buildOptionIndex() {
+        for (uint32_t seed=0; ; ++seed) {
+            OptionIndex index {seed, {}};
+            bool collision = false;
+
+            index.slots.fill(OptionIndex::Empty);
+
+            for (size_t i=0; i<Options.size() && !collision; ++i) {
+                uint8_t &slot = index.slots[optionHash(Options[i].name, seed) % OptionIndex::Size];
+
+                collision = slot != OptionIndex::Empty;
+                slot = i;
+            }
+
+            if (!collision)
+                return index;
+        }
+    }
+
+    inline constexpr OptionIndex optionIndex = buildOptionIndex();
+
+    [[nodiscard]]
+    constexpr const Option *findOption(const std::string_view name) {
+        const uint8_t idx = optionIndex.slots[optionHash(name, optionIndex.seed) % OptionIndex::Size];
+
+        return (idx != OptionIndex::Empty && Options[idx].name == name) ? &Options[idx] : nullptr;
+    }
+
+    enum struct PrintSection: int {
+        Info = 0,
+        KeyboardMouse,
+        Xinput,
+        BackButtons,
+        Rumble,
+        DeadZone,
+        Leds,
+        Count
+    };
+
+    // print --section names, indexed by PrintSection
+    inline constexpr std::array<std::string_view, static_cast<size_t>(PrintSection::Count)> PrintSections = {
+        "info", "kbm", "xinput", "back", "rumble", "deadzone", "leds"
+    };
+
+    // print --button names, index + 1 is the back button number
+    inline constexpr std::array<std::string_view, 4> BackButtonNames = {"L4", "R4", "L5", "R5"};
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(OWCCLI_SHARED)
+#ifdef OWCCLI_BUILD
+#define OWCCLI_API __declspec(dllexport)
+#else
+#define OWCCLI_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define OWCCLI_API __attribute__((visibility("default")))
+#else
+#define OWCCLI_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * libowccli, the CLI controller session for frontends that keep it open instead of spawning the CLI per action
+ *
+ * A handle owns the controller of this board, only one can be open per process. Calls are serialized internally,
+ * nothing is printed: messages of the last failed call are kept for owc_last_error.
+ *
+ * Fields use the profile key names, as in an exported profile, plus RUMBLE, LEFT_ANALOG_CENTER, LEFT_ANALOG_BOUNDARY,
+ * RIGHT_ANALOG_CENTER, RIGHT_ANALOG_BOUNDARY, LED_MODE and LED_COLOR (0xRRGGBB). Keys are strings, everything else is int.
+ * set and import change the handle only, owc_write sends what differs from the last read or write to the controller.
+ */
+
+typedef struct owc_handle owc_handle;
+
+enum owc_status {
+    OWC_OK = 0,
+    OWC_ERROR, /* controller or i/o failure, see owc_last_error */
+    OWC_EINVAL, /* bad argument, unknown field or value out of range */
+    OWC_ETYPE, /* string getter or setter on an int field, or the other way around */
+    OWC_ENOTSUP, /* field not available on this controller */
+    OWC_ESTATE, /* the config has not been read yet */
+    OWC_EBUSY, /* another handle is open */
+    OWC_ERANGE /* buffer too small */
+};
+
+enum owc_format {
+    OWC_FORMAT_YAML = 0,
+    OWC_FORMAT_OWCB
+};
+
+/* board lookup, device init and firmware version check, on failure *handle is NULL and owc_last_error(NULL) tells why */
+OWCCLI_API int owc_open(owc_handle **handle);
+OWCCLI_API void owc_close(owc_handle *handle);
+OWCCLI_API const char *owc_last_error(const owc_handle *handle);
+
+OWCCLI_API const char *owc_product(const owc_handle *handle);
+OWCCLI_API const char *owc_firmware_version(const owc_handle *handle);
+/* 1 or 2 */
+OWCCLI_API int owc_controller_type(const owc_handle *handle);
+
+OWCCLI_API int owc_read(owc_handle *handle);
+OWCCLI_API int owc_write(owc_handle *handle);
+
+OWCCLI_API int owc_get_string(owc_handle *handle, const char *field, char *buf, size_t size);
+OWCCLI_API int owc_get_int(owc_handle *handle, const char *field, int *value);
+/* {BTN}_MACRO takes a macro, see l4m */
+OWCCLI_API int owc_set_string(owc_handle *handle, const char *field, const char *value);
+OWCCLI_API int owc_set_int(owc_handle *handle, const char *field, int value);
+
+/* yaml or binary profile, the format is detected. Nothing is applied if any key fails (unknown, unresolved, bad macro) */
+OWCCLI_API int owc_import(owc_handle *handle, const char *data, size_t size);
+/* the current state, including changes not written yet, *data is released with owc_free */
+OWCCLI_API int owc_export(owc_handle *handle, int format, char **data, size_t *size);
+OWCCLI_API void owc_free(void *data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -15,187 +15,220 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#ifdef _WIN32
-#include "include/win.h"
-#endif
 #include <iostream>
-#include <fstream>
+#include <filesystem>
+#include <chrono>
 
 #include "classes/FileLogger.h"
+#include "classes/Daemon.h"
+#include "classes/ConfigCache.h"
+#include "classes/DeviceList.h"
+#include "classes/Tracer.h"
+#include "classes/DeviceSession.h"
+#include "include/Options.h"
+#include "Device.h"
 #include  "Utils.h"
-#include "extern/libOpenWinControls/src/include/ControllerFeature.h"
-#include "extern/libOpenWinControls/src/controller/ControllerV1.h"
-#include "extern/libOpenWinControls/src/controller/ControllerV2.h"
-#include "extern/yaml-cpp/include/yaml-cpp/yaml.h"
-
-static constexpr char win3[] = "G1618-03";
-static constexpr char win4[] = "G1618-04";
-static constexpr char mini24[] = "G1617-01";
-static constexpr char mini25[] = "G1617-02";
-static constexpr char mini25L[] = "G1617-02-L";
-static constexpr char max2_22[] = "G1619-04";
-static constexpr char max2_25[] = "G1619-05";
-static constexpr char win5[] = "G1618-05";
 
-[[nodiscard]]
-static std::string getProduct() {
-#ifdef __linux__
-    std::ifstream prodDmi;
-    std::string prod;
-
-    prodDmi.open("/sys/class/dmi/id/board_name");
-    if (!prodDmi.is_open())
-        return "";
-
-    std::getline(prodDmi, prod);
-    prodDmi.close();
-
-    return prod;
-#elif defined(_WIN32)
-    DWORD bufSz = 0;
-    std::unique_ptr<TCHAR[]> buf;
-    LSTATUS ret;
-    HKEY rkey;
-
-    ret = RegOpenKeyExA(HKEY_LOCAL_MACHINE, R"(HARDWARE\DESCRIPTION\System\BIOS)", 0, KEY_READ, &rkey);
-    if (ret != ERROR_SUCCESS) {
-        std::cerr << "failed to open bios subkey, code: " << ret;
-        return "";
-    }
+static void initTracer(const OWC::CMDParser &cmd) {
+    OWC::Tracer::getInstance()->init(cmd.hasArg("--trace") ? std::string(std::get<std::string_view>(cmd.getValue("--trace"))) : "", cmd.hasArg("--timings"));
+}
 
-    ret = RegGetValueA(rkey, nullptr, "BaseBoardProduct", RRF_RT_REG_SZ, nullptr, nullptr, &bufSz);
-    if (ret != ERROR_SUCCESS) {
-        std::cerr << "failed to read size for reg value, code " << ret;
-        RegCloseKey(rkey);
-        return "";
-    }
+static void initVerify(const OWC::CMDParser &cmd) {
+    OWCL::setWriteVerify(cmd.hasArg("--verify"), cmd.hasArg("--retry") ? std::get<int>(cmd.getValue("--retry")) : 0);
+}
 
-    bufSz += sizeof(TCHAR);
-    buf = std::make_unique<TCHAR[]>(bufSz);
+// board lookup, device init and the version check always run, they select and guard the controller
+[[nodiscard]]
+static bool needsConfig(const OWC::CMDParser &cmd, const int controllerType) {
+    // the reset discards it
+    if (cmd.hasArg("reset"))
+        return false;
 
-    ret = RegGetValueA(rkey, nullptr, "BaseBoardProduct", RRF_RT_REG_SZ, nullptr, buf.get(), &bufSz);
-    if (ret != ERROR_SUCCESS) {
-        std::cerr << "failed to read reg value, code " << ret;
-        RegCloseKey(rkey);
-        return "";
-    }
+    // V1 info is the firmware version only, V2 info shows the emulation mode, which comes with the config
+    if (cmd.hasArg("print") && controllerType == 1)
+        return OWCL::getPrintFilter(cmd).sections != (1 << static_cast<int>(OWC::PrintSection::Info));
 
-    RegCloseKey(rkey);
-    return std::string(buf.get());
-#else
-    return "";
-#endif
+    return true;
 }
 
 [[nodiscard]]
-static std::shared_ptr<OWC::Controller> getDevice(const std::string &product) {
-    std::shared_ptr<OWC::Controller> device;
-
-    if (product == win4)
-        device = std::make_shared<OWC::ControllerV1>(OWC::ControllerFeature::DeadZoneControlV1 | OWC::ControllerFeature::ShoulderLedsV1 | OWC::ControllerFeature::RumbleV1);
-    else if (product == mini24 || product == max2_22 || product == max2_25)
-        device = std::make_shared<OWC::ControllerV1>(OWC::ControllerFeature::DeadZoneControlV1 | OWC::ControllerFeature::RumbleV1);
-    //else if (product == win3)
-    //    device = std::make_shared<OWC::ControllerV1>();
-    else if (product == win5)
-        device = std::make_shared<OWC::ControllerV2>(OWC::ControllerFeature::RumbleV1 | OWC::ControllerFeature::XinputMappingV1 | OWC::ControllerFeature::BackButton4);
-    else if (product == mini25 || product == mini25L)
-        device = std::make_shared<OWC::ControllerV2>(OWC::ControllerFeature::DeadZoneControlV1 | OWC::ControllerFeature::RumbleV1 | OWC::ControllerFeature::XinputMappingV1);
-    else
-        std::cerr << "unknown device: " << product << "\n";
-
-    return device;
+static bool initSession(const OWC::CMDParser &cmd) {
+    OWC::DeviceSession *session = OWC::DeviceSession::getInstance();
+
+    if (cmd.hasArg("--record"))
+        return session->init(OWC::DeviceSession::Mode::Record, std::string(std::get<std::string_view>(cmd.getValue("--record"))));
+    else if (cmd.hasArg("--replay"))
+        return session->init(OWC::DeviceSession::Mode::Replay, std::string(std::get<std::string_view>(cmd.getValue("--replay"))),
+                             cmd.hasArg("--replay-speed") && std::get<std::string_view>(cmd.getValue("--replay-speed")) == "real");
+
+    return true;
 }
 
 [[nodiscard]]
-static bool isCompatible(const std::string &product, const std::shared_ptr<OWC::Controller> &gpd) {
-    std::pair<int, int> version = {0, 0};
-    bool compCheck = false;
-
-    /*if (product == win3) {
-        return true;
+static int run(const OWC::CMDParser &cmdParser, const std::vector<std::string> &args) {
+    // no device needed
+    if (cmdParser.hasArg("convert")) {
+        const std::vector<std::string_view> &files = std::get<std::vector<std::string_view>>(cmdParser.getValue("convert"));
+        const std::string inPath (files[0]), outPath (files[1]);
+        std::error_code ec;
+
+        if (std::filesystem::is_directory(inPath, ec))
+            return OWCL::convertProfiles(inPath, outPath, OWCL::getBulkOptions(cmdParser));
+
+        if (cmdParser.hasArg("--to") || cmdParser.hasArg("--jobs") || cmdParser.hasArg("--report")) {
+            std::cerr << "--to, --jobs and --report only apply to directories\n";
+            return 1;
+        }
 
-    } else*/ if (product == win4) {
-        version = std::dynamic_pointer_cast<OWC::ControllerV1>(gpd)->getKVersion();
-        compCheck = version.first >= 0x4 && version.second >= 0x7;
+        return OWCL::convertProfile(inPath, outPath, cmdParser.hasArg("--fsync"));
 
-    } else if (product == mini24) {
-        version = std::dynamic_pointer_cast<OWC::ControllerV1>(gpd)->getKVersion();
-        compCheck = version.first >= 0x5 && version.second >= 0x3;
+    } else if (cmdParser.hasArg("validate")) {
+        const std::vector<std::string_view> &paths = std::get<std::vector<std::string_view>>(cmdParser.getValue("validate"));
 
-    } else if (product == max2_22 || product == max2_25) {
-        version = std::dynamic_pointer_cast<OWC::ControllerV1>(gpd)->getKVersion();
-        compCheck = version.first >= 1 && version.second >= 0x23;
+        return OWCL::validateProfiles(std::vector<std::string>(paths.begin(), paths.end()), OWCL::getBulkOptions(cmdParser));
 
-    } else if (product == win5) {
-        version = std::dynamic_pointer_cast<OWC::ControllerV2>(gpd)->getVersion();
-        compCheck = version.first >= 1 && version.second >= 0x8;
+    } else if (cmdParser.hasArg("simulate") && (cmdParser.hasArg("--profile") || cmdParser.hasArg("--macro"))) {
+        return OWCL::simulateOffline(cmdParser);
 
-    } else if (product == mini25 || product == mini25L) {
-        version = std::dynamic_pointer_cast<OWC::ControllerV2>(gpd)->getVersion();
-        compCheck = version.first >= 1 && version.second >= 0x22;
+    } else if (cmdParser.hasArg("devices")) {
+        OWC::DeviceList::print();
+        return 0;
     }
 
-    if (!compCheck)
-        std::cout << "version " << version.first << "." << version.second << " is not supported, please update.\n";
+    OWC::DeviceSession *session = OWC::DeviceSession::getInstance();
 
-    return compCheck;
-}
+    if (!initSession(cmdParser))
+        return 1;
 
-int main(int argc, char *argv[]) {
-    OWC::CMDParser cmdParser(argc, argv);
+    // the daemon would make the controller calls, not us
+    if (session->getMode() == OWC::DeviceSession::Mode::Live && !cmdParser.hasArg("daemon")) {
+        const OWC::TraceSpan span ("forward");
+        const int ret = OWC::Daemon::forward(args);
 
-    if (!cmdParser.parse())
-        return 1;
+        // the daemon traced the command
+        if (ret != -1) {
+            OWC::Tracer::getInstance()->init("", false);
+            return ret;
+        }
+    }
 
-    const std::string product = getProduct();
-    const std::shared_ptr<OWC::Controller> gpd = getDevice(product);
+    const std::string product = session->getMode() == OWC::DeviceSession::Mode::Replay ? session->getProduct() : OWCL::getProduct();
+    const std::shared_ptr<OWC::Controller> gpd = OWCL::getDevice(product);
     OWC::FileLogger *logger = OWC::FileLogger::getInstance();
+    OWC::ConfigCache *cache = OWC::ConfigCache::getInstance();
+    OWCL::CommandInput input;
+    OWC::ConfigImage shadow;
 
     if (!gpd)
         return 1;
 
+    session->setProduct(product);
+
+    initVerify(cmdParser);
+
+    // bad input fails here, before any device traffic
+    if (OWCL::loadCommandInput(cmdParser, gpd->getControllerType(), input) != 0)
+        return 1;
+
+    // with debug off the library messages are not even copied
     if (!logger->init())
         std::cerr << "failed to init log file\n";
-    else
+    else if (logger->isEnabled(OWC::LogLevel::Debug))
         gpd->enableLogging([logger](const std::wstring &msg) { logger->writeExt(msg); });
 
-    if (!gpd->init()) {
+    if (const OWC::TraceSpan span ("device init"); !session->initDevice(gpd)) {
         std::cerr << "device initialization failed\n";
         return 1;
+    }
 
-    } else if (!gpd->readVersion()) {
+    if (const OWC::TraceSpan span ("readVersion"); !session->readVersion(gpd)) {
         std::cerr << "failed to read firmware version\n";
         return 1;
 
-    } else if (!isCompatible(product, gpd)) {
-        return 1;
-
-    } else if (!gpd->readConfig()) {
-        std::cerr << "failed to read firmware config\n";
+    } else if (!OWCL::isCompatible(product, session->getState())) {
         return 1;
     }
 
-    if (cmdParser.hasArg("print")) {
-        OWCL::printCurrentSettings(gpd);
+    OWC::Tracer::getInstance()->setMeta("board", product);
+    OWC::Tracer::getInstance()->setMeta("firmware", OWCL::getVersionString(gpd));
 
-    } else if (cmdParser.hasArg("reset")) {
-        return OWCL::resetConfig(gpd);
+    // a recording must hold every read, and a replay must not touch the cache of the real device
+    if (session->getMode() != OWC::DeviceSession::Mode::Replay)
+        cache->init(product, OWCL::getVersionString(gpd), !cmdParser.hasArg("--no-cache") && session->getMode() == OWC::DeviceSession::Mode::Live);
 
-    } else if (cmdParser.hasArg("export")) {
-        return OWCL::exportToYaml(gpd, std::get<std::string>(cmdParser.getValue("export")));
+    if (needsConfig(cmdParser, gpd->getControllerType())) {
+        // V2 print also shows device state (emulation mode, back button modes) that is not part of the config image
+        if ((cmdParser.hasArg("export") || (cmdParser.hasArg("print") && gpd->getControllerType() == 1)) && cache->load(shadow))
+            shadow.apply(gpd);
+        else if (OWCL::readConfig(gpd, shadow) != 0)
+            return 1;
+    }
 
-    } else if (cmdParser.hasArg("import")) {
-        try {
-            return OWCL::importFromYaml(gpd, std::get<std::string>(cmdParser.getValue("import")));
+    if (cmdParser.hasArg("daemon")) {
+        OWC::Daemon daemon;
 
-        } catch (const YAML::Exception &yex) {
-            std::cerr << "failed to parse yaml: " << yex.msg << "\n";
+        if (!daemon.init())
             return 1;
-        }
-    } else if (cmdParser.hasArg("set")) {
-        return OWCL::writeConfig(gpd, cmdParser);
+
+        return daemon.run([&gpd, &shadow, &product](const OWC::CMDParser &cmd)->int {
+            OWC::Tracer *tracer = OWC::Tracer::getInstance();
+            int ret;
+
+            // one trace per client command, written relative to the client directory
+            initTracer(cmd);
+            initVerify(cmd);
+            tracer->setMeta("board", product);
+            tracer->setMeta("firmware", OWCL::getVersionString(gpd));
+
+            {
+                const OWC::TraceSpan span ("command");
+                OWCL::CommandInput input;
+
+                // V2 print shows the emulation and back button modes, only a config read refreshes them after the mode switch moved
+                if (cmd.hasArg("print") && gpd->getControllerType() != 1 && OWCL::readConfig(gpd, shadow) != 0)
+                    ret = 1;
+                else
+                    ret = OWCL::loadCommandInput(cmd, gpd->getControllerType(), input) != 0 ? 1 : OWCL::runCommand(gpd, shadow, cmd, input);
+            }
+
+            // keep the in-memory config in sync with the device after a failed or reset write
+            if ((ret != 0 || cmd.hasArg("reset")) && OWCL::readConfig(gpd, shadow) != 0)
+                std::cerr << "controller config may be out of sync, restart the daemon\n";
+
+            if (!tracer->finish() && ret == 0)
+                ret = 1;
+
+            return ret;
+        });
     }
 
-    return 0;
+    return OWCL::runCommand(gpd, shadow, cmdParser, input);
+}
+
+int main(int argc, char *argv[]) {
+    OWC::Tracer *tracer = OWC::Tracer::getInstance();
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const std::vector<std::string> args (argv + 1, argv + argc);
+    OWC::CMDParser cmdParser(argc, argv);
+    int ret;
+
+    if (!cmdParser.parse())
+        return 1;
+
+    initTracer(cmdParser);
+    tracer->add("parse", start, std::chrono::steady_clock::now(), 0);
+
+    {
+        const OWC::TraceSpan span ("run");
+
+        ret = run(cmdParser, args);
+    }
+
+    if (!OWC::DeviceSession::getInstance()->finish() && ret == 0)
+        ret = 1;
+
+    if (!tracer->finish() && ret == 0)
+        ret = 1;
+
+    return ret;
 }
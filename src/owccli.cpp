@@ -0,0 +1,416 @@
+/*
+ * This file is part of OpenWinControlsCLI.
+ * Copyright (C) 2026 kylon
+ *
+ * OpenWinControlsCLI is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenWinControlsCLI is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <mutex>
+#include <unordered_map>
+
+#include "include/owccli.h"
+#include "include/Options.h"
+#include "classes/BinaryProfile.h"
+#include "classes/ConfigCache.h"
+#include "classes/ConfigImage.h"
+#include "classes/DeviceSession.h"
+#include "classes/Diagnostics.h"
+#include "classes/FileLogger.h"
+#include "classes/ProfileReader.h"
+#include "classes/ProfileWriter.h"
+#include "Device.h"
+#include "Utils.h"
+#include "extern/yaml-cpp/include/yaml-cpp/yaml.h"
+
+struct owc_handle final {
+    std::shared_ptr<OWC::Controller> gpd;
+    OWC::ConfigImage shadow; // last read or write
+    std::string product;
+    std::string firmware;
+    std::string error;
+    bool hasConfig = false;
+};
+
+static std::mutex apiMutex;
+static std::string openError;
+static bool handleOpen = false;
+
+[[nodiscard]]
+static std::string joinErrors(const OWC::Diagnostics &diag) {
+    std::string msg;
+
+    for (const std::string &error: diag.getErrors())
+        msg.append(msg.empty() ? "" : "\n").append(error);
+
+    return msg;
+}
+
+/*
+ * One API call: holds the API lock and collects the messages of the calls it makes
+ *
+ * The host streams are never touched, the collected errors become the error of a failed call.
+ */
+class CallScope final {
+private:
+    const std::lock_guard<std::mutex> lock;
+
+public:
+    OWC::Diagnostics diag {true, false};
+
+    CallScope(): lock(apiMutex) {}
+
+    int fail(std::string &error, const int status, const std::string_view msg = {}) const {
+        error = msg.empty() ? joinErrors(diag) : msg;
+
+        if (error.empty())
+            error = "failed";
+
+        return status;
+    }
+};
+
+[[nodiscard]]
+static int findField(const std::string &name) {
+    static const std::unordered_map<std::string, int> fields = [] {
+        std::unordered_map<std::string, int> map;
+
+        for (int i=0; i<OWC::ConfigImage::FieldCount; ++i)
+            map.emplace(OWC::ConfigImage::fieldName(i), i);
+
+        return map;
+    }();
+    const auto it = fields.find(name);
+
+    return it == fields.end() ? -1 : it->second;
+}
+
+[[nodiscard]]
+static bool isKeyField(const int field) {
+    const int firstSlot = OWC::ConfigImage::fieldBackButton(1, 1, OWC::ConfigImage::SlotField::Key);
+
+    return field < firstSlot || (field < OWC::ConfigImage::fieldActiveSlots(1) && (field - firstSlot) % 3 == static_cast<int>(OWC::ConfigImage::SlotField::Key));
+}
+
+// profile fields go through the profile reader, for the same key names, checks and clamping as import
+static int setProfileField(owc_handle *handle, CallScope &scope, const std::string &field, const std::string &value) {
+    const int controllerType = handle->gpd->getControllerType();
+    OWC::Diagnostics diag (true, false);
+    OWC::ConfigImage img;
+
+    try {
+        if (OWC::ProfileReader::parse(std::format("MAPPING_TYPE: {}\n{}: {}\n", controllerType, field, value), controllerType, img, diag) != OWC::ProfileReader::Result::Ok || !diag.getErrors().empty())
+            return scope.fail(handle->error, OWC_EINVAL, joinErrors(diag));
+
+    } catch (const YAML::Exception &yex) {
+        return scope.fail(handle->error, OWC_EINVAL, yex.msg);
+    }
+
+    // skipped for this controller type
+    if (img.present.none())
+        return scope.fail(handle->error, findField(field) == -1 && !field.ends_with("_MACRO") ? OWC_EINVAL : OWC_ENOTSUP, std::format("{} is not available on this controller", field));
+
+    img.apply(handle->gpd);
+    return OWC_OK;
+}
+
+// rumble, deadzone and leds, checked against the set options
+static int setDeviceField(owc_handle *handle, CallScope &scope, const int field, const int value) {
+    constexpr std::array<OWC::OptionTarget, 4> deadZoneTargets = {OWC::OptionTarget::LeftCenter, OWC::OptionTarget::LeftBoundary, OWC::OptionTarget::RightCenter, OWC::OptionTarget::RightBoundary};
+    const int deadZone = field - OWC::ConfigImage::fieldDeadZone(OWC::ConfigImage::DeadZoneField::LeftCenter);
+    OWC::OptionTarget target = OWC::OptionTarget::LedColor;
+    OWC::ConfigImage img;
+
+    if (field == OWC::ConfigImage::fieldRumble())
+        target = OWC::OptionTarget::Rumble;
+    else if (field < OWC::ConfigImage::fieldLedMode())
+        target = deadZoneTargets[deadZone];
+    else if (field == OWC::ConfigImage::fieldLedMode())
+        target = OWC::OptionTarget::LedMode;
+
+    const OWC::Option &opt = *std::ranges::find(OWC::Options, target, &OWC::Option::target);
+
+    if (!handle->gpd->hasFeature(opt.feature))
+        return scope.fail(handle->error, OWC_ENOTSUP, std::format("{} is not available on this controller", OWC::ConfigImage::fieldName(field)));
+
+    if (target == OWC::OptionTarget::LedColor ? (value < 0 || value > 0xffffff) : (value < opt.minVal || value > opt.maxVal))
+        return scope.fail(handle->error, OWC_EINVAL, std::format("{} must be in [{}, {}]", OWC::ConfigImage::fieldName(field), opt.minVal, target == OWC::OptionTarget::LedColor ? 0xffffff : opt.maxVal));
+
+    if (field == OWC::ConfigImage::fieldRumble())
+        img.rumble = value;
+    else if (field < OWC::ConfigImage::fieldLedMode())
+        img.deadZone[deadZone] = value;
+    else if (field == OWC::ConfigImage::fieldLedMode())
+        img.ledMode = value;
+    else
+        img.ledColor = {value >> 16, (value >> 8) & 0xff, value & 0xff};
+
+    img.present.set(field);
+    img.apply(handle->gpd);
+    return OWC_OK;
+}
+
+int owc_open(owc_handle **handle) {
+    OWC::DeviceSession *session = OWC::DeviceSession::getInstance();
+    OWC::FileLogger *logger = OWC::FileLogger::getInstance();
+    std::unique_ptr<owc_handle> hnd;
+    CallScope scope;
+
+    if (!handle)
+        return scope.fail(openError, OWC_EINVAL, "handle is NULL");
+
+    *handle = nullptr;
+
+    if (handleOpen)
+        return scope.fail(openError, OWC_EBUSY, "a handle is already open");
+
+    hnd = std::make_unique<owc_handle>();
+    hnd->product = OWCL::getProduct();
+    hnd->gpd = OWCL::getDevice(hnd->product, scope.diag);
+
+    if (!hnd->gpd)
+        return scope.fail(openError, OWC_ENOTSUP);
+
+    session->setProduct(hnd->product);
+
+    // logging is optional, a log that cannot be opened does not fail the call
+    if (logger->init() && logger->isEnabled(OWC::LogLevel::Debug))
+        hnd->gpd->enableLogging([logger](const std::wstring &msg) { logger->writeExt(msg); });
+
+    if (!session->initDevice(hnd->gpd))
+        return scope.fail(openError, OWC_ERROR, "device initialization failed");
+    else if (!session->readVersion(hnd->gpd))
+        return scope.fail(openError, OWC_ERROR, "failed to read firmware version");
+    else if (!OWCL::isCompatible(hnd->product, session->getState(), scope.diag))
+        return scope.fail(openError, OWC_ENOTSUP);
+
+    hnd->firmware = OWCL::getVersionString(hnd->gpd);
+
+    // never serve reads, but drop the CLI cache entry when we write
+    OWC::ConfigCache::getInstance()->init(hnd->product, hnd->firmware, false);
+
+    handleOpen = true;
+    *handle = hnd.release();
+    return OWC_OK;
+}
+
+void owc_close(owc_handle *handle) {
+    const std::lock_guard<std::mutex> lock (apiMutex);
+
+    if (!handle)
+        return;
+
+    delete handle;
+    handleOpen = false;
+}
+
+const char *owc_last_error(const owc_handle *handle) {
+    return handle ? handle->error.c_str() : openError.c_str();
+}
+
+const char *owc_product(const owc_handle *handle) {
+    return handle ? handle->product.c_str() : "";
+}
+
+const char *owc_firmware_version(const owc_handle *handle) {
+    return handle ? handle->firmware.c_str() : "";
+}
+
+int owc_controller_type(const owc_handle *handle) {
+    return handle ? handle->gpd->getControllerType() : 0;
+}
+
+int owc_read(owc_handle *handle) {
+    if (!handle)
+        return OWC_EINVAL;
+
+    CallScope scope;
+
+    if (OWCL::readConfig(handle->gpd, handle->shadow, scope.diag) != 0)
+        return scope.fail(handle->error, OWC_ERROR);
+
+    handle->hasConfig = true;
+    return OWC_OK;
+}
+
+int owc_write(owc_handle *handle) {
+    if (!handle)
+        return OWC_EINVAL;
+
+    CallScope scope;
+
+    // the whole config is written, what was never read would overwrite the controller with defaults
+    if (!handle->hasConfig)
+        return scope.fail(handle->error, OWC_ESTATE, "read the config before writing it");
+    else if (OWCL::commitConfig(handle->gpd, handle->shadow, scope.diag) != 0)
+        return scope.fail(handle->error, OWC_ERROR);
+
+    return OWC_OK;
+}
+
+int owc_get_string(owc_handle *handle, const char *field, char *buf, const size_t size) {
+    if (!handle || !field || !buf)
+        return OWC_EINVAL;
+
+    CallScope scope;
+    const int idx = findField(field);
+
+    if (!handle->hasConfig)
+        return scope.fail(handle->error, OWC_ESTATE, "read the config first");
+    else if (idx == -1)
+        return scope.fail(handle->error, OWC_EINVAL, std::format("unknown field {}", field));
+    else if (!isKeyField(idx))
+        return scope.fail(handle->error, OWC_ETYPE, std::format("{} is an int field", field));
+
+    const OWC::ConfigImage img = OWC::ConfigImage::capture(handle->gpd);
+    const std::string value = img.fieldToString(idx);
+
+    if (!img.present.test(idx))
+        return scope.fail(handle->error, OWC_ENOTSUP, std::format("{} is not available on this controller", field));
+    else if (value.size() >= size)
+        return scope.fail(handle->error, OWC_ERANGE, std::format("{} needs a buffer of {} bytes", field, value.size() + 1));
+
+    std::memcpy(buf, value.c_str(), value.size() + 1);
+    return OWC_OK;
+}
+
+int owc_get_int(owc_handle *handle, const char *field, int *value) {
+    if (!handle || !field || !value)
+        return OWC_EINVAL;
+
+    CallScope scope;
+    const int idx = findField(field);
+
+    if (!handle->hasConfig)
+        return scope.fail(handle->error, OWC_ESTATE, "read the config first");
+    else if (idx == -1)
+        return scope.fail(handle->error, OWC_EINVAL, std::format("unknown field {}", field));
+    else if (isKeyField(idx))
+        return scope.fail(handle->error, OWC_ETYPE, std::format("{} is a key field", field));
+
+    const OWC::ConfigImage img = OWC::ConfigImage::capture(handle->gpd);
+
+    if (!img.present.test(idx))
+        return scope.fail(handle->error, OWC_ENOTSUP, std::format("{} is not available on this controller", field));
+
+    if (idx == OWC::ConfigImage::fieldLedColor()) {
+        const auto [r, g, b] = img.ledColor;
+
+        *value = (r << 16) | (g << 8) | b;
+
+    } else {
+        *value = std::stoi(img.fieldToString(idx));
+    }
+
+    return OWC_OK;
+}
+
+int owc_set_string(owc_handle *handle, const char *field, const char *value) {
+    if (!handle || !field || !value)
+        return OWC_EINVAL;
+
+    CallScope scope;
+    const std::string name = field;
+    const int idx = findField(name);
+
+    if (!handle->hasConfig)
+        return scope.fail(handle->error, OWC_ESTATE, "read the config first");
+    else if (idx != -1 && !isKeyField(idx))
+        return scope.fail(handle->error, OWC_ETYPE, std::format("{} is an int field", field));
+    else if (idx == -1 && !name.ends_with("_MACRO"))
+        return scope.fail(handle->error, OWC_EINVAL, std::format("unknown field {}", field));
+    else if (std::strpbrk(value, "\"\\\r\n"))
+        return scope.fail(handle->error, OWC_EINVAL, std::format("invalid value for {}", field));
+
+    return setProfileField(handle, scope, name, std::format("\"{}\"", value));
+}
+
+int owc_set_int(owc_handle *handle, const char *field, const int value) {
+    if (!handle || !field)
+        return OWC_EINVAL;
+
+    CallScope scope;
+    const std::string name = field;
+    const int idx = findField(name);
+
+    if (!handle->hasConfig)
+        return scope.fail(handle->error, OWC_ESTATE, "read the config first");
+    else if (idx != -1 && isKeyField(idx))
+        return scope.fail(handle->error, OWC_ETYPE, std::format("{} is a key field", field));
+    else if (idx >= OWC::ConfigImage::fieldRumble())
+        return setDeviceField(handle, scope, idx, value);
+    else if (idx == -1 && !name.ends_with("_MACRO_START_TIME"))
+        return scope.fail(handle->error, OWC_EINVAL, std::format("unknown field {}", field));
+
+    return setProfileField(handle, scope, name, std::to_string(value));
+}
+
+int owc_import(owc_handle *handle, const char *data, const size_t size) {
+    if (!handle || !data)
+        return OWC_EINVAL;
+
+    CallScope scope;
+    OWC::Diagnostics diag (true, false);
+    OWC::ConfigImage img;
+    OWC::ProfileReader::Result ret;
+
+    if (!handle->hasConfig)
+        return scope.fail(handle->error, OWC_ESTATE, "read the config first");
+
+    try {
+        ret = OWC::ProfileReader::load(std::string_view(data, size), handle->gpd->getControllerType(), img, diag);
+
+    } catch (const YAML::Exception &yex) {
+        return scope.fail(handle->error, OWC_EINVAL, "failed to parse yaml: " + yex.msg);
+    }
+
+    if (ret == OWC::ProfileReader::Result::Unsupported)
+        return scope.fail(handle->error, OWC_ENOTSUP, joinErrors(diag));
+    else if (ret != OWC::ProfileReader::Result::Ok || !diag.getErrors().empty())
+        return scope.fail(handle->error, OWC_EINVAL, joinErrors(diag));
+
+    img.apply(handle->gpd);
+    return OWC_OK;
+}
+
+int owc_export(owc_handle *handle, const int format, char **data, size_t *size) {
+    if (!handle || !data || !size || (format != OWC_FORMAT_YAML && format != OWC_FORMAT_OWCB))
+        return OWC_EINVAL;
+
+    CallScope scope;
+    OWC::Diagnostics diag (true, false);
+    std::string out;
+
+    if (!handle->hasConfig)
+        return scope.fail(handle->error, OWC_ESTATE, "read the config first");
+
+    if (format == OWC_FORMAT_YAML)
+        OWC::ProfileWriter::formatYaml(OWC::ConfigImage::capture(handle->gpd), out);
+    else if (!OWC::BinaryProfile::encode(OWC::ConfigImage::capture(handle->gpd), out, diag))
+        return scope.fail(handle->error, OWC_ERROR, joinErrors(diag));
+
+    *data = static_cast<char *>(std::malloc(out.size() + 1));
+    if (!*data)
+        return scope.fail(handle->error, OWC_ERROR, "out of memory");
+
+    std::memcpy(*data, out.c_str(), out.size() + 1);
+    *size = out.size();
+    return OWC_OK;
+}
+
+void owc_free(void *data) {
+    std::free(data);
+}